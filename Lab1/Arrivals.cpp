@@ -0,0 +1,27 @@
+/*
+ * File:   Arrivals.cpp
+ */
+
+#include "Arrivals.h"
+
+StreamArrivals::StreamArrivals(ProcessStream& stream_) : stream(stream_) {
+    pending = stream.next(line);
+}
+
+int StreamArrivals::admit(ProcessState& state) {
+    int index;
+    if (!freeRows.empty()) {
+        index = freeRows.back();
+        freeRows.pop_back();
+        processes.set(index, index, line.arrival_time, line.total_time, line.block_interval, line.weight,
+                line.deadline);
+    } else {
+        index = processes.add(processes.size(), line.arrival_time, line.total_time, line.block_interval,
+                line.weight, line.deadline);
+        state.resize(processes.size());
+    }
+    processes.names.set(index, line.name); //copied, the line buffer is reused
+    state.reset(index);
+    pending = stream.next(line);
+    return index;
+}
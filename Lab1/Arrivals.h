@@ -0,0 +1,89 @@
+/*
+ * Arrivals - where the Scheduler's simulation gets its processes from
+ * 
+ * Scheduler::Simulate is a template over the arrival source as well as the
+ * policy. A source provides:
+ * 
+ *  table()         the ProcessTable rows of admitted processes
+ *  empty()         true once every process has arrived
+ *  time()          arrival time of the next process (not empty)
+ *  admit(state)    makes the next process a table row, initializes its
+ *                  ProcessState row and returns its index
+ *  retire(index)   the process terminated; its row may be reused
+ * 
+ * and says whether runs can be checkpointed (RESUMABLE); if so it also
+ * provides save(out) and load(in) for its position in the input.
+ * 
+ * TableArrivals replays a table parsed up front. StreamArrivals reads
+ * processes lazily from a ProcessStream and reuses the rows of terminated
+ * processes, so memory depends on the number of processes alive at once
+ * rather than on the length of the input.
+ */
+
+/*
+ * File:   Arrivals.h
+ */
+
+#ifndef ARRIVALS_H
+#define ARRIVALS_H
+
+#include <vector>
+
+#include "Checkpoint.h"
+#include "InputLine.h"
+#include "ProcessStream.h"
+#include "ProcessTable.h"
+
+/**
+ * Processes of a table read in full before the simulation
+ */
+class TableArrivals {
+public:
+    static constexpr bool RESUMABLE = true;
+
+    TableArrivals(const ProcessTable& processes_) : processes(processes_), nextArrival(0) {}
+
+    const ProcessTable& table() const { return processes; }
+    bool empty() const { return nextArrival == processes.size(); }
+    long long time() const { return processes.arrival_time[nextArrival]; }
+    int admit(ProcessState& state) { //resets the row, which may differ from the table a snapshot was taken on
+        state.reset(nextArrival);
+        return nextArrival++;
+    }
+    void retire(int /*index*/) {}
+    void save(CheckpointWriter& out) const { out.put(nextArrival); }
+    void load(CheckpointReader& in) { nextArrival = in.get<int>(); }
+
+private:
+    const ProcessTable& processes;
+    int nextArrival; //input is sorted by arrival time
+};
+
+/**
+ * Processes read from a stream as simulated time reaches their arrival
+ */
+class StreamArrivals {
+public:
+    static constexpr bool RESUMABLE = false; //standard input cannot be read again
+
+    /**
+     * Constructor - reads the first process
+     * @param stream_
+     */
+    StreamArrivals(ProcessStream& stream_);
+
+    const ProcessTable& table() const { return processes; }
+    bool empty() const { return !pending; }
+    long long time() const { return line.arrival_time; }
+    int admit(ProcessState& state);
+    void retire(int index) { freeRows.push_back(index); }
+
+private:
+    ProcessStream& stream;
+    ProcessTable processes; //rows of live processes; names are stored per row
+    InputLine line; //next process to arrive, if pending
+    bool pending; //line holds a process
+    std::vector<int> freeRows; //rows of terminated processes
+};
+
+#endif /* ARRIVALS_H */
@@ -0,0 +1,75 @@
+/*
+ * File:   Benchmark.cpp
+ */
+
+#include "Benchmark.h"
+#include "GreenRuntime.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+using std::cout;
+using std::cerr;
+
+Benchmark::Benchmark(int max_processes, const WorkloadGenerator::Settings& workload,
+        const Scheduler::Options& options) {
+    cout << "ALG\tPROCESSES\tEVENTS\tSECONDS\tEVENTS_PER_SEC\tPEAK_RSS_KB" << std::endl;
+    for (long long count = 1000; count <= max_processes; count *= 10) {
+        WorkloadGenerator::Settings settings = workload;
+        settings.count = count;
+        std::string path = WriteWorkload(settings);
+
+        auto start = std::chrono::steady_clock::now();
+        Scheduler s(path); //parse only
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        unlink(path.c_str()); //the mapping stays valid
+        cout << "PARSE\t" << count << "\t" << count << "\t" << seconds << "\t" << count / seconds
+                << "\t" << PeakRss() << std::endl;
+
+        s.TimeRuns(options);
+    }
+}
+
+void Benchmark::GreenThreads(int count, const WorkloadGenerator::Settings& workload,
+        const Scheduler::Options& options, long long unit_ns) {
+    cout << "SWAPCONTEXT_NS\t" << GreenRuntime::SwapNanoseconds(1000000) << std::endl;
+    cout << "MIX\tALG\tWORKERS\tTASKS\tSWITCHES\tNS_PER_SWITCH\tPREEMPTIONS\tSECONDS\tTASKS_PER_SEC"
+            "\tAVG_TURNAROUND\tSIM_AVG_TURNAROUND" << std::endl;
+    const char* mixes[] = {"CPU", "MIXED", "IO"};
+    double io_fractions[] = {0, workload.io_fraction, 1};
+    for (int m = 0; m < 3; ++m) {
+        WorkloadGenerator::Settings settings = workload;
+        settings.count = count;
+        settings.io_fraction = io_fractions[m];
+        std::string path = WriteWorkload(settings);
+        Scheduler s(path); //parse only
+        unlink(path.c_str());
+        s.TimeGreenThreads(options, unit_ns, mixes[m]);
+    }
+}
+
+std::string Benchmark::WriteWorkload(const WorkloadGenerator::Settings& settings) {
+    char path[] = "/tmp/lab1-benchXXXXXX";
+    int fd = mkstemp(path);
+    if (fd == -1) {
+        cerr << "ERROR: failure while creating file: " << path << "\n";
+        exit(2);
+    }
+    {
+        WorkloadGenerator generator(settings);
+        OutputWriter out(fd);
+        generator.Write(out);
+    }
+    close(fd);
+    return path;
+}
+
+long Benchmark::PeakRss() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
@@ -0,0 +1,79 @@
+/*
+ * Benchmark - scheduler performance on generated workloads
+ * 
+ * Generates workloads of 1k, 10k, ... processes up to a maximum, parses each
+ * one and times every selected policy on it, printing one line per run:
+ *  ALG PROCESSES EVENTS SECONDS EVENTS_PER_SEC PEAK_RSS_KB
+ * ALG "PARSE" times reading the input file; its events are input lines.
+ * Simulated events are arrivals, unblocks and finished intervals. Peak RSS
+ * is the high-water mark of the whole program so far, so with workloads run
+ * smallest first it shows the memory the largest workload so far needed.
+ * 
+ * GreenThreads() instead runs the policies for real on green threads, to
+ * check the simulated rankings against real execution.
+ */
+
+/*
+ * File:   Benchmark.h
+ */
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <string>
+
+#include "Scheduler.h"
+#include "WorkloadGenerator.h"
+
+class Benchmark {
+public:
+    /**
+     * Constructor - run the benchmark and print the results to standard output
+     * 
+     * Each workload is written to a temporary file which is removed once it
+     * has been parsed. Writes an error and exits with status 2 if the file
+     * cannot be created.
+     * 
+     * @param max_processes largest workload size
+     * @param workload shape of the workloads (count is set per run)
+     * @param options policies and simulation settings
+     */
+    Benchmark(int max_processes, const WorkloadGenerator::Settings& workload,
+            const Scheduler::Options& options);
+    ~Benchmark() {}
+
+    Benchmark(const Benchmark &other) = delete;
+    Benchmark(Benchmark &&other) = delete;
+    Benchmark operator=(const Benchmark &other) = delete;
+    Benchmark operator=(Benchmark &&other) = delete;
+
+    /**
+     * Runs a workload of each kind - CPU-bound only, the generator's mix
+     * and I/O-bound only - for real as green threads and simulated (see
+     * Scheduler::TimeGreenThreads), after a line with the cost of a bare
+     * swapcontext:
+     *  SWAPCONTEXT_NS ns
+     * @param count processes per workload
+     * @param workload shape of the workloads (io_fraction is set per mix)
+     * @param options policies and settings; cpus is the number of workers
+     * @param unit_ns real nanoseconds of one time unit
+     */
+    static void GreenThreads(int count, const WorkloadGenerator::Settings& workload,
+            const Scheduler::Options& options, long long unit_ns);
+
+    /**
+     * @return peak resident set size of the program so far, in KB
+     */
+    static long PeakRss();
+
+private:
+    /**
+     * Writes a generated workload to a new temporary file; writes an error
+     * and exits with status 2 if the file cannot be created
+     * @param settings
+     * @return name of the file
+     */
+    static std::string WriteWorkload(const WorkloadGenerator::Settings& settings);
+};
+
+#endif /* BENCHMARK_H */
@@ -0,0 +1,87 @@
+/*
+ * File:   Checkpoint.cpp
+ */
+
+#include "Checkpoint.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <iostream>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+const char MAGIC[8] = {'L', 'A', 'B', '1', 'C', 'K', 'P', 'T'};
+const int VERSION = 5; //changes whenever the layout does
+}
+
+CheckpointWriter::CheckpointWriter(const std::string& file_name_) : fileName(file_name_) {
+    buffer.insert(buffer.end(), MAGIC, MAGIC + sizeof (MAGIC));
+    put(VERSION);
+}
+
+void CheckpointWriter::put_string(std::string_view s) {
+    put(static_cast<long long> (s.size()));
+    buffer.insert(buffer.end(), s.begin(), s.end());
+}
+
+void CheckpointWriter::commit() {
+    std::string temporary = fileName + ".tmp";
+    int fd = open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    bool ok = fd != -1;
+    const char* data = buffer.data();
+    size_t size = buffer.size();
+    while (ok && size > 0) {
+        ssize_t written = write(fd, data, size);
+        if (written == -1 && errno == EINTR) {
+            continue;
+        }
+        ok = written != -1;
+        data += ok ? written : 0;
+        size -= ok ? written : 0;
+    }
+    //the data must be on disk before the rename makes it the checkpoint
+    ok = ok && fsync(fd) == 0;
+    if (fd != -1) {
+        ok = close(fd) == 0 && ok;
+    }
+    if (!ok || rename(temporary.c_str(), fileName.c_str()) != 0) {
+        std::cerr << "ERROR: failure while writing checkpoint: " << fileName << "\n";
+        exit(2);
+    }
+}
+
+CheckpointReader::CheckpointReader(const std::string& file_name_)
+: fileName(file_name_), file(new MappedFile(file_name_)), data(file->data()), size(file->size()), position(0) {
+    CheckHeader();
+}
+
+CheckpointReader::CheckpointReader(const std::vector<char>& bytes)
+: fileName("<snapshot>"), data(bytes.data()), size(bytes.size()), position(0) {
+    CheckHeader();
+}
+
+void CheckpointReader::CheckHeader() {
+    if (size < sizeof (MAGIC) || memcmp(data, MAGIC, sizeof (MAGIC)) != 0) {
+        Corrupt();
+    }
+    position = sizeof (MAGIC);
+    if (get<int>() != VERSION) {
+        std::cerr << "ERROR: checkpoint written by a different version: " << fileName << "\n";
+        exit(2);
+    }
+}
+
+std::string_view CheckpointReader::get_string() {
+    long long length = get<long long>();
+    if (length < 0) {
+        Corrupt();
+    }
+    return std::string_view(Take(length), length);
+}
+
+void CheckpointReader::Corrupt() const {
+    std::cerr << "ERROR: not a valid checkpoint file: " << fileName << "\n";
+    exit(2);
+}
@@ -0,0 +1,182 @@
+/*
+ * Checkpoint - binary snapshot of a Scheduler run in progress
+ *
+ * A checkpoint holds the run's options, the process table and everything
+ * the event loop has built up so far (simulated time, process states, ready
+ * queues, blocked processes, CPUs and statistics), so the run can be resumed
+ * later or continued several times with different settings. Values are
+ * stored in the machine's own byte order; a checkpoint is meant to be read
+ * back by the same build that wrote it.
+ *
+ * Each class that takes part provides save(CheckpointWriter&) and
+ * load(CheckpointReader&), which must read exactly what save wrote.
+ */
+
+/*
+ * File:   Checkpoint.h
+ */
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "MappedFile.h"
+
+class CheckpointWriter {
+public:
+    /**
+     * Constructor - start an empty checkpoint (nothing is written before commit)
+     * @param file_name_
+     */
+    CheckpointWriter(const std::string& file_name_);
+
+    /**
+     * Constructor - start an in-memory snapshot, taken with release()
+     */
+    CheckpointWriter() : CheckpointWriter(std::string()) {}
+    ~CheckpointWriter() {}
+
+    CheckpointWriter(const CheckpointWriter &other) = delete;
+    CheckpointWriter(CheckpointWriter &&other) = delete;
+    CheckpointWriter operator=(const CheckpointWriter &other) = delete;
+    CheckpointWriter operator=(CheckpointWriter &&other) = delete;
+
+    /**
+     * Appends the bytes of a plain value
+     * @param value
+     */
+    template <class T>
+    void put(const T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "only plain values can be saved");
+        const char* bytes = reinterpret_cast<const char*> (&value);
+        buffer.insert(buffer.end(), bytes, bytes + sizeof (T));
+    }
+
+    /**
+     * Appends the length and elements of a vector of plain values
+     * @param values
+     */
+    template <class T>
+    void put(const std::vector<T>& values) {
+        static_assert(std::is_trivially_copyable<T>::value, "only plain values can be saved");
+        put(static_cast<long long> (values.size()));
+        const char* bytes = reinterpret_cast<const char*> (values.data());
+        buffer.insert(buffer.end(), bytes, bytes + values.size() * sizeof (T));
+    }
+
+    /**
+     * Appends the length and characters of a string
+     * @param s
+     */
+    void put_string(std::string_view s);
+
+    /**
+     * Writes the checkpoint to a temporary file and renames it over the
+     * file name, so an earlier checkpoint stays intact until the new one is
+     * complete. Writes an error and exits with status 2 on failure.
+     */
+    void commit();
+
+    /**
+     * @return contents so far, for a CheckpointReader on memory; the writer is
+     *         left empty
+     */
+    std::vector<char> release() { return std::move(buffer); }
+
+private:
+    std::string fileName;
+    std::vector<char> buffer; //checkpoint contents so far
+};
+
+class CheckpointReader {
+public:
+    /**
+     * Constructor - map a checkpoint file and check its header
+     * Writes an error and exits with status 2 if the file cannot be read or
+     * is not a checkpoint of this version.
+     * @param file_name_
+     */
+    CheckpointReader(const std::string& file_name_);
+
+    /**
+     * Constructor - read a snapshot kept in memory (see CheckpointWriter::release)
+     * @param bytes must outlive the reader
+     */
+    CheckpointReader(const std::vector<char>& bytes);
+    ~CheckpointReader() {}
+
+    CheckpointReader(const CheckpointReader &other) = delete;
+    CheckpointReader(CheckpointReader &&other) = delete;
+    CheckpointReader operator=(const CheckpointReader &other) = delete;
+    CheckpointReader operator=(CheckpointReader &&other) = delete;
+
+    template <class T>
+    T get() {
+        static_assert(std::is_trivially_copyable<T>::value, "only plain values can be loaded");
+        T value;
+        memcpy(&value, Take(sizeof (T)), sizeof (T));
+        return value;
+    }
+
+    template <class T>
+    void get(std::vector<T>& values) {
+        static_assert(std::is_trivially_copyable<T>::value, "only plain values can be loaded");
+        long long count = get<long long>();
+        if (count < 0 || count > static_cast<long long> ((size - position) / sizeof (T))) {
+            Corrupt();
+        }
+        values.resize(count);
+        memcpy(values.data(), Take(count * sizeof (T)), count * sizeof (T));
+    }
+
+    /**
+     * @return characters of the next string, valid as long as the reader
+     */
+    std::string_view get_string();
+
+    /**
+     * Position in the file, for reading the same part more than once
+     */
+    size_t tell() const { return position; }
+    void seek(size_t position_) { position = position_; }
+
+private:
+    /**
+     * Returns the next bytes of the file and moves past them; exits if the
+     * file ends first
+     * @param length
+     * @return
+     */
+    const char* Take(size_t length) {
+        if (length > size - position) {
+            Corrupt();
+        }
+        const char* bytes = data + position;
+        position += length;
+        return bytes;
+    }
+
+    /**
+     * Writes an error and exits with status 2
+     */
+    [[noreturn]] void Corrupt() const;
+
+    /**
+     * Checks the magic number and version at the start
+     */
+    void CheckHeader();
+
+    std::string fileName; //"<snapshot>" for memory
+    std::unique_ptr<MappedFile> file; //null for memory
+    const char* data; //contents of the file or snapshot
+    size_t size;
+    size_t position; //bytes read so far
+};
+
+#endif /* CHECKPOINT_H */
@@ -0,0 +1,288 @@
+/*
+ * File:   GreenRuntime.cpp
+ */
+
+#include "GreenRuntime.h"
+#include "Policies.h"
+#include "ThreadPool.h"
+
+#include <cstdint>
+
+GreenRuntime::GreenRuntime(const ProcessTable& table_, const Scheduler::Options& options_, long long unit_ns_)
+: table(table_), options(options_), unitNs(unit_ns_), tasks(table_.size()), workers(options_.cpus),
+state(table_), nextArrival(0), numDone(0), numIdle(0), switches(0), preemptions(0), measured(0),
+switchTime(0) {
+}
+
+GreenRuntime::~GreenRuntime() {
+    for (Task& task : tasks) {
+        delete[] task.stack;
+    }
+}
+
+GreenRuntime::Result GreenRuntime::Run(Scheduler::Policy policy) {
+    switch (policy) {
+        case Scheduler::ROUND_ROBIN:
+            return Execute<RoundRobinPolicy>();
+        case Scheduler::SHORTEST_PROCESS_NEXT:
+            return Execute<ShortestProcessNextPolicy>();
+        case Scheduler::PREDICTIVE_SPN:
+            return Execute<PredictiveShortestProcessNextPolicy>();
+        case Scheduler::SHORTEST_REMAINING_TIME:
+            return Execute<ShortestRemainingTimePolicy>();
+        case Scheduler::EARLIEST_DEADLINE:
+            return Execute<EarliestDeadlinePolicy>();
+        case Scheduler::STRIDE:
+            return Execute<StridePolicy>();
+        case Scheduler::LOTTERY:
+            return Execute<LotteryPolicy>();
+        case Scheduler::MULTILEVEL_FEEDBACK:
+            return Execute<MultilevelFeedbackPolicy>();
+        default:
+            return Execute<CompletelyFairPolicy>();
+    }
+}
+
+template <class PolicyType>
+GreenRuntime::Result GreenRuntime::Execute() {
+    //every run starts from the table again
+    for (int i = 0; i < table.size(); ++i) {
+        state.reset(i);
+        tasks[i].finish = 0;
+    }
+    blocked.clear();
+    nextArrival = 0;
+    numDone = 0;
+    numIdle = 0;
+    switches = 0;
+    preemptions = 0;
+    measured = 0;
+    switchTime = 0;
+
+    PolicyType policy(options, state);
+    ThreadPool pool(options.cpus);
+    start = std::chrono::steady_clock::now();
+    pool.run(options.cpus, [&](int cpu) {
+        Dispatch(policy, cpu);
+    });
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    double turnaround = 0;
+    for (int i = 0; i < table.size(); ++i) {
+        turnaround += (tasks[i].finish - table.arrival_time[i] * unitNs) / static_cast<double> (unitNs);
+    }
+    Result result;
+    result.switches = switches;
+    result.preemptions = preemptions;
+    result.switch_ns = (measured > 0) ? switchTime / static_cast<double> (measured) : 0;
+    result.seconds = seconds;
+    result.average_turnaround = (table.size() > 0) ? turnaround / table.size() : 0;
+    return result;
+}
+
+template <class PolicyType>
+void GreenRuntime::Dispatch(PolicyType& policy, int cpu) {
+    Worker& worker = workers[cpu];
+    long long lastYield = -1; //yield of the task before, -1 if the worker waited since
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        Admit(policy, Now());
+        if (numDone == table.size()) {
+            wake.notify_all();
+            return;
+        }
+
+        //first from its own queue, then by stealing from the longest one
+        int current = policy.pick_next(cpu);
+        if (current == -1) {
+            int source = -1;
+            int longest = 0;
+            for (int v = 0; v < static_cast<int> (workers.size()); ++v) {
+                if (policy.size(v) > longest) {
+                    source = v;
+                    longest = policy.size(v);
+                }
+            }
+            if (source != -1) {
+                current = policy.steal(source, cpu);
+            }
+        }
+        if (current == -1) { //sleep until the next arrival or wake-up, or until work is queued
+            long long next = -1;
+            if (nextArrival < table.size()) {
+                next = table.arrival_time[nextArrival] * unitNs;
+            }
+            if (!blocked.empty() && (next == -1 || blocked.top_time() < next)) {
+                next = blocked.top_time();
+            }
+            lastYield = -1;
+            ++numIdle;
+            if (next == -1) {
+                wake.wait(lock);
+            } else {
+                wake.wait_until(lock, start + std::chrono::nanoseconds(next));
+            }
+            --numIdle;
+            continue;
+        }
+
+        //same decision as the simulation: run to the end of the burst or of the time slice
+        Task& task = tasks[current];
+        int runTime = state.NextBurst(current);
+        char status = (runTime == state.remaining_time[current]) ? 'T' : 'B';
+        int quantum = policy.quantum(cpu, current);
+        if (quantum > 0 && quantum < runTime) {
+            runTime = quantum;
+            status = 'S';
+        }
+        state.last_cpu[current] = cpu;
+        task.worker = cpu;
+        task.budget = runTime;
+        task.ran = 0;
+        worker.running = current;
+        worker.preempt.store(false);
+        worker.progress.store(0);
+        if (task.stack == nullptr) {
+            Create(current);
+        }
+        ++switches;
+        lock.unlock();
+        swapcontext(&worker.scheduler, &task.context);
+        lock.lock();
+
+        if (lastYield != -1) {
+            switchTime += worker.resumed - lastYield;
+            ++measured;
+        }
+        lastYield = worker.yielded;
+        worker.running = -1;
+        int ran = task.ran;
+        if (ran < task.budget) {
+            status = 'P';
+            ++preemptions;
+        }
+        if (status == 'T') {
+            state.remaining_time[current] = 0;
+            state.flags[current] |= ProcessState::TERMINATED;
+            task.finish = worker.yielded;
+            ++numDone;
+            policy.on_exit(current, ran);
+            delete[] task.stack; //not running, so no longer in use
+            task.stack = nullptr;
+        } else if (status == 'B') {
+            state.remaining_time[current] -= ran;
+            state.time_until_blocked[current] = table.block_interval[current];
+            state.flags[current] |= ProcessState::BLOCKED;
+            blocked.push(worker.yielded + options.block_duration * unitNs, current);
+            policy.on_block(current, ran);
+        } else {
+            state.remaining_time[current] -= ran;
+            state.time_until_blocked[current] -= ran;
+            if (status == 'S') {
+                policy.on_expire(current, ran);
+            } else {
+                policy.on_preempt(current, ran);
+            }
+            policy.enqueue(cpu, current);
+        }
+        if (numIdle > 0) { //queued work, a new wake-up time or the end of the run
+            wake.notify_all();
+        }
+    }
+}
+
+template <class PolicyType>
+void GreenRuntime::Admit(PolicyType& policy, long long now) {
+    policy.on_tick(now / unitNs);
+    bool queued = false;
+    while (true) {
+        bool arrived = nextArrival < table.size() && table.arrival_time[nextArrival] * unitNs <= now;
+        if (!blocked.empty() && blocked.top_time() <= now &&
+                (!arrived || blocked.top_time() <= table.arrival_time[nextArrival] * unitNs)) {
+            int index = blocked.pop();
+            state.flags[index] &= ~ProcessState::BLOCKED;
+            policy.enqueue(state.last_cpu[index], index);
+        } else if (arrived) {
+            int index = nextArrival++;
+            policy.on_arrive(index);
+            int target = 0;
+            int targetLoad = -1;
+            for (int c = 0; c < static_cast<int> (workers.size()); ++c) {
+                int load = policy.size(c) + (workers[c].running != -1 ? 1 : 0);
+                if (targetLoad == -1 || load < targetLoad) {
+                    target = c;
+                    targetLoad = load;
+                }
+            }
+            policy.enqueue(target, index);
+        } else {
+            break;
+        }
+        queued = true;
+    }
+    if constexpr (PolicyType::PREEMPTIVE) {
+        for (int c = 0; queued && c < static_cast<int> (workers.size()); ++c) {
+            int current = workers[c].running;
+            if (current != -1 && policy.preempts(c, current, workers[c].progress.load())) {
+                workers[c].preempt.store(true);
+            }
+        }
+    }
+}
+
+void GreenRuntime::Body(unsigned int high, unsigned int low, int index) {
+    GreenRuntime* runtime = reinterpret_cast<GreenRuntime*> ((static_cast<uintptr_t> (high) << 32) | low);
+    Task& task = runtime->tasks[index];
+    while (true) {
+        //the worker changes when the task is stolen
+        Worker& worker = runtime->workers[task.worker];
+        worker.resumed = runtime->Now();
+        while (task.ran < task.budget && !worker.preempt.load(std::memory_order_relaxed)) {
+            long long end = runtime->Now() + runtime->unitNs;
+            while (runtime->Now() < end) {
+            }
+            ++task.ran;
+            worker.progress.store(task.ran, std::memory_order_relaxed);
+        }
+        worker.yielded = runtime->Now();
+        swapcontext(&task.context, &worker.scheduler);
+    }
+}
+
+void GreenRuntime::Create(int index) {
+    Task& task = tasks[index];
+    task.stack = new char[STACK_SIZE];
+    getcontext(&task.context);
+    task.context.uc_stack.ss_sp = task.stack;
+    task.context.uc_stack.ss_size = STACK_SIZE;
+    task.context.uc_link = nullptr; //Body never returns
+    uintptr_t self = reinterpret_cast<uintptr_t> (this);
+    makecontext(&task.context, reinterpret_cast<void (*)()> (Body), 3, static_cast<unsigned int> (self >> 32),
+            static_cast<unsigned int> (self), index);
+}
+
+namespace {
+ucontext_t pingContext; //SwapNanoseconds' caller
+ucontext_t pongContext; //switches straight back
+
+void Pong() {
+    while (true) {
+        swapcontext(&pongContext, &pingContext);
+    }
+}
+}
+
+double GreenRuntime::SwapNanoseconds(int rounds) {
+    std::vector<char> stack(STACK_SIZE);
+    getcontext(&pongContext);
+    pongContext.uc_stack.ss_sp = stack.data();
+    pongContext.uc_stack.ss_size = stack.size();
+    pongContext.uc_link = nullptr;
+    makecontext(&pongContext, Pong, 0);
+    auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds / 2; ++i) { //there and back: two switches
+        swapcontext(&pingContext, &pongContext);
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count();
+    return (rounds >= 2) ? ns / (rounds / 2 * 2) : 0;
+}
@@ -0,0 +1,179 @@
+/*
+ * GreenRuntime - runs a workload for real as user-level threads, scheduled
+ * by the same policy classes as the simulation
+ *
+ * Every process of the table becomes a green thread (a ucontext with its
+ * own stack) which burns real CPU time: one time unit of the workload is
+ * unit_ns nanoseconds of spinning. options.cpus worker threads from a
+ * ThreadPool act as the CPUs. Each worker asks the policy for its next
+ * process, switches to it, and is switched back to when the process has
+ * used up its burst (it then blocks for I/O or terminates) or its time
+ * slice, exactly as Simulate decides them. A blocked process is parked for
+ * block_duration units of wall-clock time without using a CPU. Processes
+ * arrive arrival_time units after the start.
+ *
+ * Preemption is cooperative at unit boundaries: a running green thread
+ * checks after every unit whether its slice is used up or whether a
+ * PREEMPTIVE policy has flagged its worker because a process it prefers
+ * became ready. swapcontext is not async-signal-safe, so the runtime does
+ * not switch from inside a timer signal handler.
+ *
+ * The policy, the ProcessState it reads and the blocked processes are
+ * shared by the workers under one mutex, taken once per dispatch. The cost
+ * of a switch is measured from the moment one green thread yields to the
+ * moment the next one on the same worker resumes: both swapcontext calls
+ * plus the policy's decision and the locking.
+ */
+
+/*
+ * File:   GreenRuntime.h
+ */
+
+#ifndef GREENRUNTIME_H
+#define GREENRUNTIME_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+#include <ucontext.h>
+
+#include "ProcessTable.h"
+#include "Scheduler.h"
+#include "WakeupHeap.h"
+
+class GreenRuntime {
+public:
+    /**
+     * Outcome of one real run
+     */
+    struct Result {
+        long long switches; //dispatches of a green thread
+        long long preemptions; //dispatches cut short by a PREEMPTIVE policy
+        double switch_ns; //mean yield-to-resume time between two green threads
+        double seconds; //wall-clock time of the whole run
+        double average_turnaround; //mean of termination - arrival, in time units
+    };
+
+    /**
+     * Constructor
+     * @param table_ workload; every process becomes a green thread
+     * @param options_ block_duration, time_slice, cpus (worker threads) and
+     *                 the settings of the policies
+     * @param unit_ns_ real nanoseconds of one time unit
+     */
+    GreenRuntime(const ProcessTable& table_, const Scheduler::Options& options_, long long unit_ns_);
+    ~GreenRuntime();
+
+    GreenRuntime(const GreenRuntime &other) = delete;
+    GreenRuntime(GreenRuntime &&other) = delete;
+    GreenRuntime operator=(const GreenRuntime &other) = delete;
+    GreenRuntime operator=(GreenRuntime &&other) = delete;
+
+    /**
+     * Runs every process to completion under a policy
+     * @param policy
+     * @return
+     */
+    Result Run(Scheduler::Policy policy);
+
+    /**
+     * Times bare swapcontext between two contexts on one thread
+     * @param rounds number of switches
+     * @return nanoseconds per switch
+     */
+    static double SwapNanoseconds(int rounds);
+
+private:
+    static const int STACK_SIZE = 64 * 1024; //bytes of stack per green thread
+
+    /**
+     * A green thread
+     */
+    struct Task {
+        ucontext_t context;
+        char* stack = nullptr; //allocated at the first dispatch, freed at termination
+        int worker = -1; //worker it is running on
+        int budget = 0; //time units it may run in the current dispatch
+        int ran = 0; //time units it ran in the current dispatch
+        long long finish = 0; //termination, in nanoseconds since the start
+    };
+
+    /**
+     * A worker thread, one simulated CPU
+     */
+    struct Worker {
+        ucontext_t scheduler; //worker's own context, switched back to when a task yields
+        int running = -1; //task on the worker, -1 if none
+        std::atomic<bool> preempt{false}; //asks the running task to yield now
+        std::atomic<int> progress{0}; //units the running task has done in this dispatch
+        long long yielded = 0; //time the last task yielded
+        long long resumed = 0; //time the current task resumed
+    };
+
+    /**
+     * Event loop of the worker threads
+     * @param policy
+     * @param cpu worker number
+     */
+    template <class PolicyType>
+    void Dispatch(PolicyType& policy, int cpu);
+
+    /**
+     * Queues processes which arrived or finished blocking by now, and flags
+     * workers whose task a PREEMPTIVE policy wants to stop; lock held
+     * @param policy
+     * @param now
+     */
+    template <class PolicyType>
+    void Admit(PolicyType& policy, long long now);
+
+    template <class PolicyType>
+    Result Execute();
+
+    /**
+     * Body of every green thread: spin through the budget unit by unit,
+     * then switch back to the worker, forever
+     * @param high upper half of the GreenRuntime pointer
+     * @param low lower half
+     * @param index task number
+     */
+    static void Body(unsigned int high, unsigned int low, int index);
+
+    /**
+     * Makes a task's context, with a new stack, ready to enter Body
+     * @param index
+     */
+    void Create(int index);
+
+    /**
+     * @return nanoseconds since the run started
+     */
+    long long Now() const {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    const ProcessTable& table;
+    Scheduler::Options options;
+    long long unitNs;
+    std::vector<Task> tasks;
+    std::vector<Worker> workers;
+    std::chrono::steady_clock::time_point start;
+
+    //shared by the workers, under mutex
+    std::mutex mutex;
+    std::condition_variable wake; //signalled when work is queued or the run ends
+    ProcessState state;
+    WakeupHeap blocked; //blocked tasks by wake-up time in nanoseconds
+    int nextArrival; //next process of the table to arrive
+    int numDone; //terminated processes
+    int numIdle; //workers waiting for work
+    long long switches;
+    long long preemptions;
+    long long measured; //switches timed from yield to resume
+    long long switchTime; //total of those, in nanoseconds
+};
+
+#endif /* GREENRUNTIME_H */
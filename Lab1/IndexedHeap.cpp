@@ -0,0 +1,143 @@
+/*
+ * File:   IndexedHeap.cpp
+ */
+
+#include "IndexedHeap.h"
+
+IndexedHeap::IndexedHeap(int capacity) : IndexedHeap(std::make_shared<Slots>(capacity)) {
+    heap.reserve(capacity);
+}
+
+IndexedHeap::IndexedHeap(const std::shared_ptr<Slots>& slots_)
+: slots(slots_), position(slots_->position.data()), keys(slots_->keys.data()),
+orders(slots_->orders.data()) {
+}
+
+std::vector<IndexedHeap> IndexedHeap::Group(int count, int capacity) {
+    std::shared_ptr<Slots> shared = std::make_shared<Slots>(capacity);
+    std::vector<IndexedHeap> heaps;
+    heaps.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        heaps.push_back(IndexedHeap(shared));
+    }
+    return heaps;
+}
+
+void IndexedHeap::resize(int capacity) {
+    if (static_cast<int> (slots->position.size()) < capacity) {
+        slots->position.resize(capacity, -1);
+        slots->keys.resize(capacity, 0);
+        slots->orders.resize(capacity, 0);
+    }
+    position = slots->position.data();
+    keys = slots->keys.data();
+    orders = slots->orders.data();
+}
+
+void IndexedHeap::push(int index, long long key, long long order) {
+    keys[index] = key;
+    orders[index] = order;
+    position[index] = heap.size();
+    heap.push_back(index);
+    SiftUp(heap.size() - 1);
+}
+
+int IndexedHeap::pop() {
+    int index = heap[0];
+    remove(index);
+    return index;
+}
+
+void IndexedHeap::update(int index, long long key) {
+    long long old = keys[index];
+    keys[index] = key;
+    if (key < old) {
+        SiftUp(position[index]);
+    } else {
+        SiftDown(position[index]);
+    }
+}
+
+void IndexedHeap::remove(int index) {
+    int pos = position[index];
+    if (pos == -1 || pos >= static_cast<int> (heap.size()) || heap[pos] != index) { //not in this heap
+        return;
+    }
+    position[index] = -1;
+    int last = heap.back();
+    heap.pop_back();
+    if (pos == static_cast<int> (heap.size())) {
+        return;
+    }
+    //move the last entry into the hole and restore heap order
+    heap[pos] = last;
+    position[last] = pos;
+    SiftUp(pos);
+    SiftDown(position[last]);
+}
+
+void IndexedHeap::SiftUp(int pos) {
+    int index = heap[pos];
+    while (pos > 0) {
+        int parent = (pos - 1) / arity;
+        if (!Less(index, heap[parent])) {
+            break;
+        }
+        heap[pos] = heap[parent];
+        position[heap[pos]] = pos;
+        pos = parent;
+    }
+    heap[pos] = index;
+    position[index] = pos;
+}
+
+void IndexedHeap::SiftDown(int pos) {
+    int index = heap[pos];
+    int count = heap.size();
+    while (true) {
+        int first = pos * arity + 1;
+        if (first >= count) {
+            break;
+        }
+        int smallest = first;
+        int end = (first + arity < count) ? first + arity : count;
+        for (int child = first + 1; child < end; ++child) {
+            if (Less(heap[child], heap[smallest])) {
+                smallest = child;
+            }
+        }
+        if (!Less(heap[smallest], index)) {
+            break;
+        }
+        heap[pos] = heap[smallest];
+        position[heap[pos]] = pos;
+        pos = smallest;
+    }
+    heap[pos] = index;
+    position[index] = pos;
+}
+
+void IndexedHeap::save(CheckpointWriter& out) const {
+    std::vector<long long> heapKeys(heap.size());
+    std::vector<long long> heapOrders(heap.size());
+    for (size_t i = 0; i < heap.size(); ++i) {
+        heapKeys[i] = keys[heap[i]];
+        heapOrders[i] = orders[heap[i]];
+    }
+    out.put(heap);
+    out.put(heapKeys);
+    out.put(heapOrders);
+}
+
+void IndexedHeap::load(CheckpointReader& in) {
+    std::vector<long long> heapKeys;
+    std::vector<long long> heapOrders;
+    in.get(heap); //already in heap order
+    in.get(heapKeys);
+    in.get(heapOrders);
+    for (size_t i = 0; i < heap.size(); ++i) {
+        position[heap[i]] = i;
+        keys[heap[i]] = heapKeys[i];
+        orders[heap[i]] = heapOrders[i];
+    }
+}
@@ -0,0 +1,141 @@
+/*
+ * IndexedHeap - d-ary min-heap over process indices with decrease-key
+ * 
+ * Each process index appears at most once. The heap stores only indices;
+ * keys and tie-break order live in arrays indexed by process, and a position
+ * array lets a queued process be found, re-keyed or removed in O(log N)
+ * without copying any process data. Equal keys are ordered by the order
+ * value given when the index was pushed (normally a FIFO counter).
+ * 
+ * Several heaps can share one set of per-index arrays (see Group()), as long
+ * as an index is in at most one of them at a time; per-CPU ready lists use
+ * this so their memory does not grow with the number of CPUs.
+ */
+
+/*
+ * File:   IndexedHeap.h
+ */
+
+#ifndef INDEXEDHEAP_H
+#define INDEXEDHEAP_H
+
+#include <memory>
+#include <vector>
+
+#include "Checkpoint.h"
+
+class IndexedHeap {
+public:
+    /**
+     * Constructor - allocate room for indices 0 .. capacity-1
+     * @param capacity number of processes
+     */
+    IndexedHeap(int capacity);
+    ~IndexedHeap() {}
+
+    /**
+     * Copying would share the per-index arrays by accident, so only moves
+     * are allowed
+     */
+    IndexedHeap(const IndexedHeap &other) = delete;
+    IndexedHeap(IndexedHeap &&other) = default;
+    IndexedHeap& operator=(const IndexedHeap &other) = delete;
+    IndexedHeap& operator=(IndexedHeap &&other) = default;
+
+    /**
+     * Creates heaps which share one set of per-index arrays
+     * @param count number of heaps
+     * @param capacity number of processes
+     * @return 
+     */
+    static std::vector<IndexedHeap> Group(int count, int capacity);
+
+    /**
+     * Makes room for indices 0 .. capacity-1 if there is less; heaps of a
+     * Group() share the room, but each must be told
+     * @param capacity number of processes
+     */
+    void resize(int capacity);
+
+    /**
+     * Adds an index which is not already in the heap
+     * @param index process index
+     * @param key priority (smallest comes out first)
+     * @param order tie-break between equal keys (smallest comes out first)
+     */
+    void push(int index, long long key, long long order);
+
+    /**
+     * Removes and returns the index with the smallest key (heap must not be empty)
+     * @return process index
+     */
+    int pop();
+
+    /**
+     * @return index with the smallest key (heap must not be empty)
+     */
+    int top() const { return heap[0]; }
+
+    /**
+     * Changes the key of an index in the heap, moving it up or down as needed
+     * @param index process index
+     * @param key new key
+     */
+    void update(int index, long long key);
+
+    /**
+     * Removes an index from the heap if present
+     * @param index process index
+     */
+    void remove(int index);
+
+    bool contains(int index) const {
+        int pos = position[index];
+        return pos != -1 && pos < static_cast<int> (heap.size()) && heap[pos] == index;
+    }
+    long long key(int index) const { return keys[index]; }
+    bool empty() const { return heap.empty(); }
+    int size() const { return heap.size(); }
+
+    /**
+     * Writes the indices in the heap with their keys and orders
+     * @param out
+     */
+    void save(CheckpointWriter& out) const;
+
+    /**
+     * Replaces the contents with the indices written by save(); room for
+     * them must already have been made
+     * @param in
+     */
+    void load(CheckpointReader& in);
+
+private:
+    static const int arity = 4; //children per node
+
+    struct Slots {
+        std::vector<int> position; //position of each index in its heap, -1 if absent
+        std::vector<long long> keys; //key of each index
+        std::vector<long long> orders; //tie-break order of each index
+
+        Slots(int capacity) : position(capacity, -1), keys(capacity, 0), orders(capacity, 0) {}
+    };
+
+    IndexedHeap(const std::shared_ptr<Slots>& slots_);
+
+    std::vector<int> heap; //process indices in heap order
+    std::shared_ptr<Slots> slots; //per-index arrays, possibly shared with other heaps
+    //shortcuts into *slots
+    int* position;
+    long long* keys;
+    long long* orders;
+
+    bool Less(int a, int b) const {
+        return keys[a] < keys[b] || (keys[a] == keys[b] && orders[a] < orders[b]);
+    }
+
+    void SiftUp(int pos);
+    void SiftDown(int pos);
+};
+
+#endif /* INDEXEDHEAP_H */
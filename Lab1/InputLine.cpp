@@ -0,0 +1,66 @@
+/*
+ * File:   InputLine.cpp
+ */
+
+#include "InputLine.h"
+
+#include <climits>
+
+const char* InputLine::Parse(const char* p, const char* end, InputLine& line) {
+    line = InputLine();
+
+    //fields: name, then integers; blank lines are ignored
+    SkipBlanks(p, end);
+    if (p == end) {
+        return nullptr;
+    }
+    const char* name = p;
+    while (p != end && *p != ' ' && *p != '\t' && *p != '\r') {
+        ++p;
+    }
+    line.name = std::string_view(name, p - name);
+
+    //arrival_time, total_time, block_interval, then the optional weight and deadline
+    int* fields[] = {&line.arrival_time, &line.total_time, &line.block_interval, &line.weight, &line.deadline};
+    for (int f = 0; f < 5; ++f) {
+        SkipBlanks(p, end);
+        if (p == end) {
+            if (f < 3) {
+                return "expected name arrival_time total_time block_interval [weight [deadline]]";
+            }
+            break;
+        } else if (!ParseInt(p, end, *fields[f])) {
+            return "invalid number";
+        }
+    }
+    SkipBlanks(p, end);
+    if (p != end) {
+        return "unexpected text after deadline";
+    } else if (line.weight == 0) {
+        return "weight must be positive";
+    }
+    return nullptr;
+}
+
+void InputLine::SkipBlanks(const char*& p, const char* end) {
+    while (p != end && (*p == ' ' || *p == '\t' || *p == '\r')) {
+        ++p;
+    }
+}
+
+bool InputLine::ParseInt(const char*& p, const char* end, int& value) {
+    long long result = 0;
+    const char* start = p;
+    while (p != end && *p >= '0' && *p <= '9') {
+        result = result * 10 + (*p - '0');
+        if (result > INT_MAX) {
+            return false;
+        }
+        ++p;
+    }
+    if (p == start || (p != end && *p != ' ' && *p != '\t' && *p != '\r')) {
+        return false;
+    }
+    value = result;
+    return true;
+}
@@ -0,0 +1,57 @@
+/*
+ * InputLine - one parsed line of a Scheduler input file
+ * 
+ * Shared by the file parser and the online stream reader so both accept
+ * exactly the same format: name arrival_time total_time block_interval
+ * [weight [deadline]], separated by blanks, non-negative decimal integers.
+ */
+
+/*
+ * File:   InputLine.h
+ */
+
+#ifndef INPUTLINE_H
+#define INPUTLINE_H
+
+#include <string_view>
+
+#include "ProcessTable.h"
+
+struct InputLine {
+    std::string_view name; //points into the parsed text
+    int arrival_time = 0;
+    int total_time = 0;
+    int block_interval = 0;
+    int weight = ProcessTable::DEFAULT_WEIGHT;
+    int deadline = 0; //relative to arrival_time, 0 for none
+
+    /**
+     * Parses one line (without its newline)
+     * @param p start of the line
+     * @param end end of the line
+     * @param line receives the fields
+     * @return nullptr if the line is valid, otherwise an error message;
+     *         blank lines are valid and leave line.name empty
+     */
+    static const char* Parse(const char* p, const char* end, InputLine& line);
+
+private:
+    /**
+     * Advances p past spaces, tabs and carriage returns
+     * @param p
+     * @param end end of the line
+     */
+    static void SkipBlanks(const char*& p, const char* end);
+
+    /**
+     * Parses a non-negative decimal integer which must be followed by a
+     * blank or the end of the line
+     * @param p start of the number (advanced past it)
+     * @param end end of the line
+     * @param value receives the number
+     * @return false if there is no valid number at p
+     */
+    static bool ParseInt(const char*& p, const char* end, int& value);
+};
+
+#endif /* INPUTLINE_H */
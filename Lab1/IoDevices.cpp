@@ -0,0 +1,159 @@
+/*
+ * File:   IoDevices.cpp
+ */
+
+#include "IoDevices.h"
+
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+
+IoDevices::IoDevices(const ProcessTable& table_, int count, Discipline discipline_, int service_time_,
+        int seek_time_)
+: table(table_), discipline(discipline_), serviceTime(service_time_), seekTime(seek_time_), devices(count),
+waiting(count), orderCount(0) {
+    resize(table_.size());
+}
+
+void IoDevices::resize(int count) {
+    if (enabled() && count > static_cast<int> (device.size())) {
+        device.resize(count, 0);
+        track.resize(count, 0);
+        requests.resize(count, 0);
+        since.resize(count, 0);
+        awayTime.resize(count, 0);
+    }
+}
+
+void IoDevices::block(long long time, int index, WakeupHeap& wakeups) {
+    if (!enabled()) {
+        wakeups.push(time + serviceTime, index);
+        return;
+    }
+    int d = Hash(index, 0) % devices.size();
+    device[index] = d;
+    track[index] = Hash(index, ++requests[index]) % TRACKS;
+    since[index] = time;
+    Device& disk = devices[d];
+    disk.queue.record(waiting[d].size() + (disk.serving != -1 ? 1 : 0));
+    ++disk.requests;
+    if (disk.serving == -1) {
+        Serve(time, d, index, wakeups);
+    } else {
+        waiting[d].emplace(discipline == FIFO ? 0 : track[index], orderCount, index);
+    }
+    ++orderCount;
+}
+
+void IoDevices::unblock(long long time, int index, WakeupHeap& wakeups) {
+    if (!enabled()) {
+        return;
+    }
+    awayTime[index] += time - since[index];
+    int d = device[index];
+    devices[d].serving = -1;
+    std::set<std::tuple<int, long long, int> >& queue = waiting[d];
+    if (queue.empty()) {
+        return;
+    }
+    int head = devices[d].head;
+    auto next = queue.begin(); //FIFO: the oldest request
+    if (discipline != FIFO) {
+        //first request at or above the head
+        next = queue.lower_bound(std::make_tuple(head, LLONG_MIN, INT_MIN));
+        if (discipline == CLOOK && next == queue.end()) {
+            next = queue.begin(); //sweep back to the lowest track
+        } else if (discipline == SSTF && next != queue.begin()) {
+            //or the oldest request on the closest track below it
+            int below = std::get<0>(*std::prev(next));
+            if (next == queue.end() || head - below < std::get<0>(*next) - head) {
+                next = queue.lower_bound(std::make_tuple(below, LLONG_MIN, INT_MIN));
+            }
+        }
+    }
+    int chosen = std::get<2>(*next);
+    queue.erase(next);
+    Serve(time, d, chosen, wakeups);
+}
+
+void IoDevices::Serve(long long time, int d, int index, WakeupHeap& wakeups) {
+    Device& disk = devices[d];
+    long long service = serviceTime + llround(static_cast<double> (seekTime) * abs(track[index] - disk.head) / TRACKS);
+    disk.head = track[index];
+    disk.serving = index;
+    disk.busy += service;
+    wait.record(time - since[index]);
+    wakeups.push(time + service, index);
+}
+
+unsigned long long IoDevices::Hash(int index, unsigned long long salt) const {
+    //FNV-1a over the name, then a splitmix64 finalizer with the salt mixed in
+    unsigned long long hash = 14695981039346656037ULL;
+    for (char c : table.name(index)) {
+        hash = (hash ^ static_cast<unsigned char> (c)) * 1099511628211ULL;
+    }
+    hash += salt * 0x9e3779b97f4a7c15ULL;
+    hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebULL;
+    return hash ^ (hash >> 31);
+}
+
+void IoDevices::write(OutputWriter& out, long long finish_time) const {
+    for (int d = 0; d < static_cast<int> (devices.size()); ++d) {
+        const Device& disk = devices[d];
+        out << " <device>\t" << d << "\t" << disk.requests << "\t" << disk.busy << "\t"
+                << (finish_time > 0 ? disk.busy / static_cast<double> (finish_time) : 0.0) << "\t"
+                << disk.queue.mean() << "\t" << disk.queue.percentile(50) << "\t" << disk.queue.percentile(90)
+                << "\t" << disk.queue.percentile(99) << "\t" << disk.queue.max() << '\n';
+    }
+    out << " <io_wait>\t" << wait.mean() << "\t" << wait.percentile(50) << "\t" << wait.percentile(90) << "\t"
+            << wait.percentile(99) << "\t" << wait.max() << '\n';
+}
+
+void IoDevices::save(CheckpointWriter& out) const {
+    out.put(devices);
+    for (const std::set<std::tuple<int, long long, int> >& queue : waiting) {
+        std::vector<int> keys;
+        std::vector<long long> orders;
+        std::vector<int> indices;
+        for (const std::tuple<int, long long, int>& entry : queue) {
+            keys.push_back(std::get<0>(entry));
+            orders.push_back(std::get<1>(entry));
+            indices.push_back(std::get<2>(entry));
+        }
+        out.put(keys);
+        out.put(orders);
+        out.put(indices);
+    }
+    out.put(device);
+    out.put(track);
+    out.put(requests);
+    out.put(since);
+    out.put(awayTime);
+    out.put(orderCount);
+    out.put(wait);
+}
+
+void IoDevices::load(CheckpointReader& in) {
+    in.get(devices);
+    waiting.resize(devices.size());
+    for (std::set<std::tuple<int, long long, int> >& queue : waiting) {
+        std::vector<int> keys;
+        std::vector<long long> orders;
+        std::vector<int> indices;
+        in.get(keys);
+        in.get(orders);
+        in.get(indices);
+        queue.clear();
+        for (size_t i = 0; i < indices.size() && i < keys.size() && i < orders.size(); ++i) {
+            queue.emplace_hint(queue.end(), keys[i], orders[i], indices[i]); //already sorted
+        }
+    }
+    in.get(device);
+    in.get(track);
+    in.get(requests);
+    in.get(since);
+    in.get(awayTime);
+    orderCount = in.get<long long>();
+    wait = in.get<LatencyHistogram>();
+}
@@ -0,0 +1,171 @@
+/*
+ * IoDevices - queueing model of the I/O devices processes block on
+ *
+ * Without it a blocked process is away for exactly block_duration, however
+ * many others are blocked, as if I/O were infinitely parallel. Here each
+ * block is a request to one of a fixed number of devices, each serving one
+ * request at a time from its own queue: the process is away for the time
+ * its request waits plus its service time, so contention shows up as
+ * queueing delay.
+ *
+ * Devices are simulated disks. Every request goes to a track (0 ..
+ * TRACKS-1) and the service time is block_duration plus a seek from the
+ * track of the previous request, seek_time * distance / TRACKS. The
+ * discipline picks the next request when a device becomes free:
+ *  FIFO    in the order requests were made
+ *  SSTF    shortest seek first: the track closest to the head
+ *  CLOOK   elevator: the next track at or above the head, wrapping around
+ *          to the lowest one
+ * A process's device and each request's track are a hash of its name and
+ * the number of its request, so they do not depend on process indices.
+ *
+ * Requests in service are the ones in the scheduler's WakeupHeap, with
+ * their completion time; waiting requests are kept here, ordered for the
+ * discipline in a std::set per device (O(log N) to add or pick).
+ */
+
+/*
+ * File:   IoDevices.h
+ */
+
+#ifndef IODEVICES_H
+#define IODEVICES_H
+
+#include <set>
+#include <tuple>
+#include <vector>
+
+#include "Checkpoint.h"
+#include "LatencyHistogram.h"
+#include "OutputWriter.h"
+#include "ProcessTable.h"
+#include "WakeupHeap.h"
+
+class IoDevices {
+public:
+    static const int TRACKS = 1024; //tracks per simulated disk
+
+    /**
+     * Order in which a device serves waiting requests
+     */
+    enum Discipline {
+        FIFO, SSTF, CLOOK
+    };
+
+    /**
+     * Constructor - no devices turns the model off: blocks last
+     * block_duration and every call below returns at once
+     * @param table_ processes (names for the device and track hash)
+     * @param count number of devices
+     * @param discipline_
+     * @param service_time_ time to serve a request without seeking (block_duration)
+     * @param seek_time_ time to seek across the whole disk
+     */
+    IoDevices(const ProcessTable& table_, int count, Discipline discipline_, int service_time_,
+            int seek_time_);
+    ~IoDevices() {}
+
+    IoDevices(const IoDevices &other) = delete;
+    IoDevices(IoDevices &&other) = delete;
+    IoDevices operator=(const IoDevices &other) = delete;
+    IoDevices operator=(IoDevices &&other) = delete;
+
+    bool enabled() const { return !devices.empty(); }
+
+    /**
+     * Makes room for indices 0 .. count-1 if there is less
+     * @param count
+     */
+    void resize(int count);
+
+    /**
+     * A new process arrived, possibly reusing the index of one which
+     * terminated
+     * @param index
+     */
+    void on_arrive(int index) {
+        if (enabled()) {
+            requests[index] = 0;
+            awayTime[index] = 0;
+        }
+    }
+
+    /**
+     * A process blocked: queues its request, or starts serving it at once if
+     * the device is free (pushing the completion time to wakeups)
+     * @param time
+     * @param index
+     * @param wakeups
+     */
+    void block(long long time, int index, WakeupHeap& wakeups);
+
+    /**
+     * A process's request completed (it just left wakeups): the device
+     * starts serving its next request, if any
+     * @param time
+     * @param index
+     * @param wakeups
+     */
+    void unblock(long long time, int index, WakeupHeap& wakeups);
+
+    /**
+     * @param index
+     * @return total time the process has spent blocked, queueing or served
+     */
+    long long away_time(int index) const { return awayTime[index]; }
+
+    /**
+     * Writes one line per device and the waiting time distribution (see
+     * Scheduler.h)
+     * @param out
+     * @param finish_time
+     */
+    void write(OutputWriter& out, long long finish_time) const;
+
+    void save(CheckpointWriter& out) const;
+    void load(CheckpointReader& in);
+
+private:
+    /**
+     * State and statistics of one device
+     */
+    struct Device {
+        int head = 0; //track of the request served last
+        int serving = -1; //process whose request is in service, -1 if idle
+        long long requests = 0; //requests made so far
+        long long busy = 0; //time spent serving
+        LatencyHistogram queue; //requests ahead (waiting or in service) when one is made
+    };
+
+    /**
+     * Starts serving a request on a free device
+     * @param time
+     * @param d device
+     * @param index
+     * @param wakeups
+     */
+    void Serve(long long time, int d, int index, WakeupHeap& wakeups);
+
+    /**
+     * @param index
+     * @param salt
+     * @return hash of the process's name and salt
+     */
+    unsigned long long Hash(int index, unsigned long long salt) const;
+
+    const ProcessTable& table;
+    Discipline discipline;
+    int serviceTime;
+    int seekTime;
+    std::vector<Device> devices;
+    std::vector<std::set<std::tuple<int, long long, int> > > waiting; //(key, order, index) per device; key is the track, 0 for FIFO
+    std::vector<int> device; //per process, device of its current request
+    std::vector<int> track; //per process, track of its current request
+    std::vector<int> requests; //per process, requests made so far
+    std::vector<long long> since; //per process, time its current request was made
+    std::vector<long long> awayTime; //per process, total time blocked
+    long long orderCount; //requests made so far, over all devices (FIFO tie-break)
+    LatencyHistogram wait; //time requests spent queued before service
+};
+
+#endif /* IODEVICES_H */
@@ -0,0 +1,57 @@
+/*
+ * File:   LatencyHistogram.cpp
+ */
+
+#include "LatencyHistogram.h"
+
+#include <cstring>
+
+LatencyHistogram::LatencyHistogram() : total(0), sum(0), largest(0) {
+    memset(counts, 0, sizeof (counts));
+}
+
+void LatencyHistogram::record(long long value) {
+    if (value < 0) {
+        value = 0;
+    }
+    ++counts[Bucket(value)];
+    ++total;
+    sum += value;
+    largest = (value > largest) ? value : largest;
+}
+
+long long LatencyHistogram::percentile(double p) const {
+    if (total == 0) {
+        return 0;
+    }
+    long long rank = static_cast<long long> (p / 100.0 * total + 0.999999);
+    rank = (rank < 1) ? 1 : (rank > total ? total : rank);
+    long long seen = 0;
+    for (int b = 0; b < BUCKETS; ++b) {
+        seen += counts[b];
+        if (seen >= rank) {
+            long long bound = UpperBound(b);
+            return (bound < largest) ? bound : largest;
+        }
+    }
+    return largest;
+}
+
+int LatencyHistogram::Bucket(long long value) {
+    if (value < 2 * HALF) {
+        return value;
+    }
+    //shift so the top SUB_BITS bits of the value select the bucket
+    int magnitude = 63 - __builtin_clzll(value);
+    int shift = magnitude - (SUB_BITS - 1);
+    return (shift + 1) * HALF + static_cast<int> ((value >> shift) - HALF);
+}
+
+long long LatencyHistogram::UpperBound(int bucket) {
+    if (bucket < 2 * HALF) {
+        return bucket;
+    }
+    int shift = bucket / HALF - 1;
+    long long lower = static_cast<long long> (HALF + bucket % HALF) << shift;
+    return lower + (1LL << shift) - 1;
+}
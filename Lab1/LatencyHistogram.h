@@ -0,0 +1,63 @@
+/*
+ * LatencyHistogram - constant-memory log-bucketed histogram of times
+ * 
+ * Values are counted in buckets whose width grows with the value (HDR
+ * style): values below 64 are exact, and every power of two above that is
+ * split into 32 equal buckets, so a reported percentile is within about 3%
+ * of the true value. Memory does not depend on the number of values, so
+ * statistics can be gathered while the simulation runs instead of from
+ * per-process columns afterwards.
+ */
+
+/*
+ * File:   LatencyHistogram.h
+ */
+
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+class LatencyHistogram {
+public:
+    LatencyHistogram();
+
+    /**
+     * Counts one value (negative values count as 0)
+     * @param value
+     */
+    void record(long long value);
+
+    /**
+     * @param p percentage, 0 to 100
+     * @return smallest bucket upper bound at or below which p% of the values
+     *         fall (never more than max()), 0 if nothing was recorded
+     */
+    long long percentile(double p) const;
+
+    long long count() const { return total; }
+    long long max() const { return largest; }
+    double mean() const { return total > 0 ? sum / static_cast<double> (total) : 0.0; }
+
+private:
+    static const int SUB_BITS = 6; //values below 2^SUB_BITS are exact
+    static const int HALF = 1 << (SUB_BITS - 1); //buckets per power of two
+    static const int BUCKETS = (64 - SUB_BITS + 2) * HALF;
+
+    /**
+     * @param value non-negative
+     * @return bucket counting the value
+     */
+    static int Bucket(long long value);
+
+    /**
+     * @param bucket
+     * @return largest value counted in the bucket
+     */
+    static long long UpperBound(int bucket);
+
+    long long counts[BUCKETS]; //values per bucket
+    long long total; //number of values
+    long long sum; //sum of the values
+    long long largest; //largest value
+};
+
+#endif /* LATENCYHISTOGRAM_H */
@@ -0,0 +1,42 @@
+/*
+ * File:   MappedFile.cpp
+ */
+
+#include "MappedFile.h"
+
+#include <iostream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedFile::MappedFile(const std::string &file_name) : base(nullptr), length(0) {
+    int fd = open(file_name.c_str(), O_RDONLY);
+    if (fd == -1) {
+        std::cerr << "ERROR: file not found: " << file_name << "\n";
+        exit(2);
+    }
+    struct stat info;
+    if (fstat(fd, &info) == -1) {
+        std::cerr << "ERROR: failure while reading file: " << file_name << "\n";
+        exit(2);
+    }
+    length = info.st_size;
+    if (length > 0) { //mmap rejects empty mappings
+        void* mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) {
+            std::cerr << "ERROR: failure while reading file: " << file_name << "\n";
+            exit(2);
+        }
+        madvise(mapping, length, MADV_SEQUENTIAL);
+        base = static_cast<const char*> (mapping);
+    }
+    close(fd);
+}
+
+MappedFile::~MappedFile() {
+    if (base != nullptr) {
+        munmap(const_cast<char*> (base), length);
+    }
+}
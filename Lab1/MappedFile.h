@@ -0,0 +1,49 @@
+/*
+ * MappedFile - read-only memory mapping of an input file
+ * 
+ * The whole file is mapped once and parsed in place; strings taken from the
+ * file can be kept as views into the mapping for as long as the MappedFile
+ * exists.
+ */
+
+/*
+ * File:   MappedFile.h
+ */
+
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+
+class MappedFile {
+public:
+    /**
+     * Constructor - map the named file
+     * 
+     * Writes an error and exits with status 2 if the file cannot be opened
+     * or mapped.
+     * 
+     * @param file_name
+     */
+    MappedFile(const std::string &file_name);
+
+    /**
+     * Destructor - unmap the file
+     */
+    ~MappedFile();
+
+    MappedFile(const MappedFile &other) = delete;
+    MappedFile(MappedFile &&other) = delete;
+    MappedFile operator=(const MappedFile &other) = delete;
+    MappedFile operator=(MappedFile &&other) = delete;
+
+    const char* data() const { return base; }
+    size_t size() const { return length; }
+
+private:
+    const char* base; //start of the mapping (nullptr for an empty file)
+    size_t length; //size of the file in bytes
+};
+
+#endif /* MAPPEDFILE_H */
@@ -0,0 +1,44 @@
+/*
+ * File:   OutputWriter.cpp
+ */
+
+#include "OutputWriter.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <iostream>
+
+#include <unistd.h>
+
+OutputWriter::OutputWriter(int fd_, size_t capacity) : fd(fd_), buffer(capacity), used(0) {
+}
+
+OutputWriter::~OutputWriter() {
+    flush();
+}
+
+OutputWriter& OutputWriter::operator<<(double value) {
+    char text[32];
+    int length = snprintf(text, sizeof (text), "%g", value);
+    return *this << std::string_view(text, length);
+}
+
+void OutputWriter::flush() {
+    Write(buffer.data(), used);
+    used = 0;
+}
+
+void OutputWriter::Write(const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t written = write(fd, data, size);
+        if (written == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            std::cerr << "ERROR: failure while writing output\n";
+            exit(2);
+        }
+        data += written;
+        size -= written;
+    }
+}
@@ -0,0 +1,125 @@
+/*
+ * OutputWriter - buffered bulk writer for the Scheduler's interval lines
+ * 
+ * Text is formatted straight into one large reusable buffer, integers by a
+ * hand-rolled formatter, and handed to the file descriptor in big chunks
+ * instead of one write per line.
+ */
+
+/*
+ * File:   OutputWriter.h
+ */
+
+#ifndef OUTPUTWRITER_H
+#define OUTPUTWRITER_H
+
+#include <cstddef>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+class OutputWriter {
+public:
+    /**
+     * Constructor - empty buffer for a file descriptor
+     * @param fd_ descriptor to write to (not closed by the writer)
+     * @param capacity size of the buffer in bytes
+     */
+    OutputWriter(int fd_, size_t capacity = 1 << 20);
+
+    /**
+     * Destructor - write whatever is still buffered
+     */
+    ~OutputWriter();
+
+    OutputWriter(const OutputWriter &other) = delete;
+    OutputWriter(OutputWriter &&other) = delete;
+    OutputWriter operator=(const OutputWriter &other) = delete;
+    OutputWriter operator=(OutputWriter &&other) = delete;
+
+    OutputWriter& operator<<(char c) {
+        if (used == buffer.size()) {
+            flush();
+        }
+        buffer[used++] = c;
+        return *this;
+    }
+
+    OutputWriter& operator<<(std::string_view text) {
+        if (text.size() > buffer.size() - used) {
+            flush();
+            if (text.size() > buffer.size()) {
+                Write(text.data(), text.size());
+                return *this;
+            }
+        }
+        memcpy(&buffer[used], text.data(), text.size());
+        used += text.size();
+        return *this;
+    }
+
+    OutputWriter& operator<<(const char* text) {
+        return *this << std::string_view(text);
+    }
+
+    OutputWriter& operator<<(int value) {
+        return *this << static_cast<long long> (value);
+    }
+
+    /**
+     * Formats a decimal integer without going through a locale or stream
+     * @param value
+     * @return *this
+     */
+    OutputWriter& operator<<(long long value) {
+        if (value < 0) {
+            *this << '-';
+            return *this << (0ULL - value);
+        }
+        return *this << static_cast<unsigned long long> (value);
+    }
+
+    OutputWriter& operator<<(unsigned long long value) {
+        if (buffer.size() - used < 20) {
+            flush();
+        }
+        char digits[20];
+        int count = 0;
+        do {
+            digits[count++] = '0' + value % 10;
+            value /= 10;
+        } while (value != 0);
+        while (count > 0) {
+            buffer[used++] = digits[--count];
+        }
+        return *this;
+    }
+
+    /**
+     * Formats a floating point value the way std::ostream does by default
+     * (6 significant digits, %g)
+     * @param value
+     * @return *this
+     */
+    OutputWriter& operator<<(double value);
+
+    /**
+     * Writes out everything buffered so far
+     */
+    void flush();
+
+private:
+    /**
+     * Writes bytes to the descriptor, retrying short writes
+     * Writes an error and exits with status 2 if the write fails
+     * @param data
+     * @param size
+     */
+    void Write(const char* data, size_t size);
+
+    int fd; //descriptor written to
+    std::vector<char> buffer; //formatted text not yet written
+    size_t used; //bytes of buffer in use
+};
+
+#endif /* OUTPUTWRITER_H */
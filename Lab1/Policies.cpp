@@ -0,0 +1,357 @@
+/*
+ * File:   Policies.cpp
+ */
+
+#include "Policies.h"
+
+#include <iostream>
+#include <sstream>
+
+RoundRobinPolicy::RoundRobinPolicy(const Scheduler::Options& options, const ProcessState& state)
+: queues(options.cpus, ReadyQueue(options.cpus == 1 ? state.table.size() : 16)),
+timeSlice(options.time_slice) {
+}
+
+void RoundRobinPolicy::save(CheckpointWriter& out) const {
+    for (const ReadyQueue& queue : queues) {
+        queue.save(out);
+    }
+}
+
+void RoundRobinPolicy::load(CheckpointReader& in) {
+    for (ReadyQueue& queue : queues) {
+        queue.load(in);
+    }
+}
+
+ShortestProcessNextPolicy::ShortestProcessNextPolicy(const Scheduler::Options& options,
+        const ProcessState& state_)
+: state(state_), queues(IndexedHeap::Group(options.cpus, state_.table.size())), readyCount(0),
+timeSlice(options.time_slice) {
+}
+
+void ShortestProcessNextPolicy::save(CheckpointWriter& out) const {
+    for (const IndexedHeap& heap : queues) {
+        heap.save(out);
+    }
+    out.put(readyCount);
+}
+
+void ShortestProcessNextPolicy::load(CheckpointReader& in) {
+    for (IndexedHeap& heap : queues) {
+        heap.load(in);
+    }
+    readyCount = in.get<long long>();
+}
+
+PredictiveShortestProcessNextPolicy::PredictiveShortestProcessNextPolicy(const Scheduler::Options& options,
+        const ProcessState& state)
+: queues(IndexedHeap::Group(options.cpus, state.table.size())), prediction(state.table.size(), options.burst_guess),
+burstSoFar(state.table.size(), 0), readyCount(0), alpha(options.burst_alpha), guess(options.burst_guess) {
+}
+
+void PredictiveShortestProcessNextPolicy::save(CheckpointWriter& out) const {
+    for (const IndexedHeap& heap : queues) {
+        heap.save(out);
+    }
+    out.put(prediction);
+    out.put(burstSoFar);
+    out.put(readyCount);
+}
+
+void PredictiveShortestProcessNextPolicy::load(CheckpointReader& in) {
+    for (IndexedHeap& heap : queues) {
+        heap.load(in);
+    }
+    in.get(prediction);
+    in.get(burstSoFar);
+    readyCount = in.get<long long>();
+}
+
+MultilevelFeedbackPolicy::MultilevelFeedbackPolicy(const Scheduler::Options& options,
+        const ProcessState& state)
+: quanta(options.mlfq_quanta), sizes(options.cpus, 0), level(state.table.size(), 0),
+levelEpoch(state.table.size(), 0), epoch(0), boostPeriod(options.mlfq_boost),
+nextBoost(options.mlfq_boost) {
+    if (quanta.empty()) {
+        quanta = {options.time_slice, options.time_slice * 2, options.time_slice * 4};
+    }
+    numLevels = quanta.size();
+    queues.assign(options.cpus * numLevels, ReadyQueue(16));
+}
+
+void MultilevelFeedbackPolicy::describe(OutputWriter& out) const {
+    for (int l = 0; l < numLevels; ++l) {
+        out << (l > 0 ? "," : "") << quanta[l];
+    }
+    if (boostPeriod > 0) {
+        out << " boost=" << boostPeriod;
+    }
+}
+
+void MultilevelFeedbackPolicy::save(CheckpointWriter& out) const {
+    out.put(numLevels);
+    out.put(sizes);
+    for (const ReadyQueue& queue : queues) {
+        queue.save(out);
+    }
+    out.put(level);
+    out.put(levelEpoch);
+    out.put(epoch);
+    out.put(nextBoost);
+}
+
+void MultilevelFeedbackPolicy::load(CheckpointReader& in) {
+    if (in.get<int>() != numLevels) { //the quanta come from the options
+        std::cerr << "ERROR: checkpoint has a different number of MLFQ levels\n";
+        exit(2);
+    }
+    in.get(sizes);
+    for (ReadyQueue& queue : queues) {
+        queue.load(in);
+    }
+    in.get(level);
+    in.get(levelEpoch);
+    epoch = in.get<int>();
+    nextBoost = in.get<long long>();
+}
+
+void MultilevelFeedbackPolicy::Boost(long long time) {
+    //every process not yet moved in this epoch reads as level 0
+    ++epoch;
+    nextBoost = (time / boostPeriod + 1) * boostPeriod;
+    for (int c = 0; c < static_cast<int> (sizes.size()); ++c) {
+        ReadyQueue* levels = &queues[c * numLevels];
+        for (int l = 1; l < numLevels; ++l) {
+            while (!levels[l].empty()) {
+                levels[0].push(levels[l].pop());
+            }
+        }
+    }
+}
+
+CompletelyFairPolicy::CompletelyFairPolicy(const Scheduler::Options& options, const ProcessState& state_)
+: state(state_), queues(options.cpus), vruntime(state_.table.size(), 0), minVruntime(options.cpus, 0),
+queuedWeight(options.cpus, 0), readyCount(0), granularity(options.time_slice) {
+    latency = (options.cfs_latency > 0) ? options.cfs_latency : 8 * granularity;
+}
+
+void CompletelyFairPolicy::enqueue(int cpu, int index) {
+    //new processes start at the floor, sleepers get at most half a latency of credit
+    long long floor = minVruntime[cpu];
+    if (state.last_cpu[index] != -1) {
+        floor -= (static_cast<long long> (latency) << 10) / 2;
+    }
+    if (vruntime[index] < floor) {
+        vruntime[index] = floor;
+    }
+    queues[cpu].emplace(vruntime[index], readyCount++, index);
+    queuedWeight[cpu] += state.table.weight[index];
+}
+
+int CompletelyFairPolicy::pick_next(int cpu) {
+    if (queues[cpu].empty()) {
+        return -1;
+    }
+    int index = TakeFirst(cpu);
+    if (vruntime[index] > minVruntime[cpu]) {
+        minVruntime[cpu] = vruntime[index];
+    }
+    return index;
+}
+
+int CompletelyFairPolicy::steal(int victim, int cpu) {
+    if (queues[victim].empty()) {
+        return -1;
+    }
+    //keep the process's lead or lag relative to the floor of its new CPU
+    int index = TakeFirst(victim);
+    vruntime[index] += minVruntime[cpu] - minVruntime[victim];
+    if (vruntime[index] > minVruntime[cpu]) {
+        minVruntime[cpu] = vruntime[index];
+    }
+    return index;
+}
+
+int CompletelyFairPolicy::quantum(int cpu, int index) const {
+    //the process's share of one scheduling period over everything ready on this CPU
+    long long ready = queues[cpu].size() + 1;
+    long long period = (ready * granularity > latency) ? ready * granularity : latency;
+    long long weight = state.table.weight[index];
+    long long slice = period * weight / (queuedWeight[cpu] + weight);
+    return (slice > granularity) ? slice : granularity;
+}
+
+void CompletelyFairPolicy::save(CheckpointWriter& out) const {
+    for (const std::set<std::tuple<long long, long long, int> >& queue : queues) {
+        std::vector<long long> runtimes;
+        std::vector<long long> orders;
+        std::vector<int> indices;
+        for (const std::tuple<long long, long long, int>& entry : queue) {
+            runtimes.push_back(std::get<0>(entry));
+            orders.push_back(std::get<1>(entry));
+            indices.push_back(std::get<2>(entry));
+        }
+        out.put(runtimes);
+        out.put(orders);
+        out.put(indices);
+    }
+    out.put(vruntime);
+    out.put(minVruntime);
+    out.put(queuedWeight);
+    out.put(readyCount);
+}
+
+void CompletelyFairPolicy::load(CheckpointReader& in) {
+    for (std::set<std::tuple<long long, long long, int> >& queue : queues) {
+        std::vector<long long> runtimes;
+        std::vector<long long> orders;
+        std::vector<int> indices;
+        in.get(runtimes);
+        in.get(orders);
+        in.get(indices);
+        queue.clear();
+        for (size_t i = 0; i < indices.size() && i < runtimes.size() && i < orders.size(); ++i) {
+            queue.emplace_hint(queue.end(), runtimes[i], orders[i], indices[i]); //already sorted
+        }
+    }
+    in.get(vruntime);
+    in.get(minVruntime);
+    in.get(queuedWeight);
+    readyCount = in.get<long long>();
+}
+
+int CompletelyFairPolicy::TakeFirst(int cpu) {
+    int index = std::get<2>(*queues[cpu].begin());
+    queues[cpu].erase(queues[cpu].begin());
+    queuedWeight[cpu] -= state.table.weight[index];
+    return index;
+}
+
+StridePolicy::StridePolicy(const Scheduler::Options& options, const ProcessState& state_)
+: state(state_), queues(IndexedHeap::Group(options.cpus, state_.table.size())), pass(state_.table.size(), 0),
+remain(state_.table.size(), 0), away(state_.table.size(), 0), globalPass(options.cpus, 0), readyCount(0),
+timeSlice(options.time_slice) {
+}
+
+void StridePolicy::enqueue(int cpu, int index) {
+    if (away[index]) {
+        pass[index] = globalPass[cpu] + remain[index];
+        away[index] = 0;
+    }
+    queues[cpu].push(index, pass[index], readyCount++);
+}
+
+int StridePolicy::pick_next(int cpu) {
+    if (queues[cpu].empty()) {
+        return -1;
+    }
+    int index = queues[cpu].pop();
+    if (pass[index] > globalPass[cpu]) {
+        globalPass[cpu] = pass[index];
+    }
+    return index;
+}
+
+int StridePolicy::steal(int victim, int cpu) {
+    if (queues[victim].empty()) {
+        return -1;
+    }
+    //keep the process's lead or lag relative to the global pass of its new CPU
+    int index = queues[victim].pop();
+    pass[index] += globalPass[cpu] - globalPass[victim];
+    if (pass[index] > globalPass[cpu]) {
+        globalPass[cpu] = pass[index];
+    }
+    return index;
+}
+
+void StridePolicy::resize(int count) {
+    for (IndexedHeap& heap : queues) {
+        heap.resize(count);
+    }
+    if (count > static_cast<int> (pass.size())) {
+        pass.resize(count, 0);
+        remain.resize(count, 0);
+        away.resize(count, 0);
+    }
+}
+
+void StridePolicy::save(CheckpointWriter& out) const {
+    for (const IndexedHeap& heap : queues) {
+        heap.save(out);
+    }
+    out.put(pass);
+    out.put(remain);
+    out.put(away);
+    out.put(globalPass);
+    out.put(readyCount);
+}
+
+void StridePolicy::load(CheckpointReader& in) {
+    for (IndexedHeap& heap : queues) {
+        heap.load(in);
+    }
+    in.get(pass);
+    in.get(remain);
+    in.get(away);
+    in.get(globalPass);
+    readyCount = in.get<long long>();
+}
+
+LotteryPolicy::LotteryPolicy(const Scheduler::Options& options, const ProcessState& state_)
+: state(state_), trees(options.cpus, TicketTree(state_.table.size())), sizes(options.cpus, 0),
+random(options.lottery_seed), seed(options.lottery_seed), timeSlice(options.time_slice) {
+}
+
+int LotteryPolicy::pick_next(int cpu) {
+    if (sizes[cpu] == 0) {
+        return -1;
+    }
+    //the modulo bias is total / 2^64, far below anything a run could show
+    TicketTree& tree = trees[cpu];
+    int index = tree.find(random() % tree.total());
+    tree.add(index, -state.table.weight[index]);
+    --sizes[cpu];
+    return index;
+}
+
+void LotteryPolicy::save(CheckpointWriter& out) const {
+    for (const TicketTree& tree : trees) {
+        tree.save(out);
+    }
+    out.put(sizes);
+    std::ostringstream engine;
+    engine << random;
+    out.put_string(engine.str());
+}
+
+void LotteryPolicy::load(CheckpointReader& in) {
+    for (TicketTree& tree : trees) {
+        tree.load(in);
+    }
+    in.get(sizes);
+    std::istringstream engine{std::string(in.get_string())};
+    if (!(engine >> random)) {
+        std::cerr << "ERROR: checkpoint has an invalid lottery state\n";
+        exit(2);
+    }
+}
+
+EarliestDeadlinePolicy::EarliestDeadlinePolicy(const Scheduler::Options& options, const ProcessState& state_)
+: state(state_), queues(IndexedHeap::Group(options.cpus, state_.table.size())), readyCount(0) {
+}
+
+void EarliestDeadlinePolicy::save(CheckpointWriter& out) const {
+    for (const IndexedHeap& heap : queues) {
+        heap.save(out);
+    }
+    out.put(readyCount);
+}
+
+void EarliestDeadlinePolicy::load(CheckpointReader& in) {
+    for (IndexedHeap& heap : queues) {
+        heap.load(in);
+    }
+    readyCount = in.get<long long>();
+}
@@ -0,0 +1,520 @@
+/*
+ * Policies - scheduling policies plugged into the Scheduler's simulation
+ * 
+ * Scheduler::Simulate is a template over the policy type, so every call the
+ * event loop makes into a policy is resolved at compile time and can be
+ * inlined. A policy owns the ready queues of every CPU and provides:
+ * 
+ *  enqueue(cpu, index)     a process became ready (arrived, unblocked or its
+ *                          time slice ended) and is queued on the CPU
+ *  pick_next(cpu)          removes and returns the CPU's next process, or -1
+ *  steal(victim, cpu)      removes and returns a process from another CPU's
+ *                          queue for an idle CPU, or -1
+ *  size(cpu)               number of processes queued on the CPU
+ *  quantum(cpu, index)     time slice for a process just picked, 0 for none
+ *  describe(out)           parameters printed after block_duration in the
+ *                          header line
+ *  save(out), load(in)     write and restore the queues and any other state
+ *                          built up during the run, for checkpoints; the
+ *                          settings come from the options instead
+ * 
+ * and may hide the no-op hooks of SchedulingPolicy:
+ * 
+ *  resize(count)           process indices now go up to count-1 (online mode
+ *                          admits processes during the run)
+ *  on_arrive(index)        a new process arrived, possibly reusing the index
+ *                          of one which terminated
+ *  on_tick(time)           once per event time, before processes are queued
+ *  on_block(index, run)    a process blocked after running for run
+ *  on_expire(index, run)   a process's time slice ended
+ *  on_preempt(index, run)  a process was preempted (PREEMPTIVE policies only)
+ *  on_exit(index, run)     a process terminated
+ * 
+ * A policy with PREEMPTIVE set is also asked, after arrivals and unblocks
+ * are queued, whether the process running on each CPU should give way:
+ * 
+ *  preempts(cpu, index, run)   true to stop the running process, which has
+ *                              run for run time units of its interval
+ * 
+ * Its interval lines are then written when the interval ends rather than
+ * when it starts, since the length is not known before.
+ * 
+ * Adding a policy means adding a class here and a Scheduler::Policy value
+ * which names it; the event loop itself does not change.
+ */
+
+/*
+ * File:   Policies.h
+ */
+
+#ifndef POLICIES_H
+#define POLICIES_H
+
+#include <climits>
+#include <cmath>
+#include <random>
+#include <set>
+#include <tuple>
+#include <vector>
+
+#include "Checkpoint.h"
+#include "IndexedHeap.h"
+#include "OutputWriter.h"
+#include "ProcessTable.h"
+#include "ReadyQueue.h"
+#include "Scheduler.h"
+#include "TicketTree.h"
+
+/**
+ * Default hooks for policies which do not need them
+ */
+class SchedulingPolicy {
+public:
+    static constexpr bool PREEMPTIVE = false;
+
+    bool preempts(int /*cpu*/, int /*index*/, int /*runTime*/) const { return false; }
+    void resize(int /*count*/) {}
+    void on_arrive(int /*index*/) {}
+    void on_tick(long long /*time*/) {}
+    void on_block(int /*index*/, int /*runTime*/) {}
+    void on_expire(int /*index*/, int /*runTime*/) {}
+    void on_preempt(int /*index*/, int /*runTime*/) {}
+    void on_exit(int /*index*/, int /*runTime*/) {}
+};
+
+/**
+ * Round robin: one FIFO queue per CPU, fixed time slice
+ */
+class RoundRobinPolicy : public SchedulingPolicy {
+public:
+    static constexpr const char* NAME = "RR";
+
+    RoundRobinPolicy(const Scheduler::Options& options, const ProcessState& state);
+
+    void enqueue(int cpu, int index) { queues[cpu].push(index); }
+    int pick_next(int cpu) { return queues[cpu].empty() ? -1 : queues[cpu].pop(); }
+    int steal(int victim, int /*cpu*/) { return queues[victim].empty() ? -1 : queues[victim].pop_back(); }
+    int size(int cpu) const { return queues[cpu].size(); }
+    int quantum(int /*cpu*/, int /*index*/) const { return timeSlice; }
+    void describe(OutputWriter& out) const { out << timeSlice; }
+    void save(CheckpointWriter& out) const;
+    void load(CheckpointReader& in);
+
+private:
+    std::vector<ReadyQueue> queues; //ready processes per CPU
+    int timeSlice;
+};
+
+/**
+ * Shortest process next: one heap per CPU keyed on the next CPU burst, ties
+ * in the order processes became ready; no time slice
+ */
+class ShortestProcessNextPolicy : public SchedulingPolicy {
+public:
+    static constexpr const char* NAME = "SPN";
+
+    ShortestProcessNextPolicy(const Scheduler::Options& options, const ProcessState& state_);
+
+    void enqueue(int cpu, int index) { queues[cpu].push(index, state.NextBurst(index), readyCount++); }
+    void resize(int count) {
+        for (IndexedHeap& heap : queues) {
+            heap.resize(count);
+        }
+    }
+    int pick_next(int cpu) { return queues[cpu].empty() ? -1 : queues[cpu].pop(); }
+    int steal(int victim, int /*cpu*/) { return pick_next(victim); }
+    int size(int cpu) const { return queues[cpu].size(); }
+    int quantum(int /*cpu*/, int /*index*/) const { return 0; }
+    void describe(OutputWriter& out) const { out << timeSlice; }
+    void save(CheckpointWriter& out) const;
+    void load(CheckpointReader& in);
+
+private:
+    const ProcessState& state;
+    std::vector<IndexedHeap> queues; //ready processes per CPU
+    long long readyCount; //insertions so far (FIFO tie-break)
+    int timeSlice; //printed in the header only
+};
+
+/**
+ * Predictive shortest process next: like SPN, but keyed on a prediction of
+ * the next CPU burst instead of the true one. The prediction is an
+ * exponential average of the bursts seen so far,
+ *  prediction = alpha * last_burst + (1 - alpha) * prediction
+ * starting from burst_guess. A burst is the CPU time from becoming ready
+ * after arriving or unblocking until blocking or terminating; no time slice.
+ */
+class PredictiveShortestProcessNextPolicy : public SchedulingPolicy {
+public:
+    static constexpr const char* NAME = "PSPN";
+
+    PredictiveShortestProcessNextPolicy(const Scheduler::Options& options, const ProcessState& state);
+
+    void enqueue(int cpu, int index) { queues[cpu].push(index, Remaining(index), readyCount++); }
+    int pick_next(int cpu) { return queues[cpu].empty() ? -1 : queues[cpu].pop(); }
+    int steal(int victim, int /*cpu*/) { return pick_next(victim); }
+    int size(int cpu) const { return queues[cpu].size(); }
+    int quantum(int /*cpu*/, int /*index*/) const { return 0; }
+    void describe(OutputWriter& out) const { out << "alpha=" << alpha << " guess=" << guess; }
+    void save(CheckpointWriter& out) const;
+    void load(CheckpointReader& in);
+
+    void resize(int count) {
+        for (IndexedHeap& heap : queues) {
+            heap.resize(count);
+        }
+        prediction.resize(count, guess);
+        burstSoFar.resize(count, 0);
+    }
+
+    void on_arrive(int index) {
+        prediction[index] = guess;
+        burstSoFar[index] = 0;
+    }
+
+    void on_block(int index, int runTime) { Observe(index, runTime); }
+    void on_preempt(int index, int runTime) { burstSoFar[index] += runTime; }
+
+protected:
+    /**
+     * @param index
+     * @return predicted CPU time until the process's current burst ends
+     */
+    long long Remaining(int index) const {
+        double left = prediction[index] - burstSoFar[index];
+        return left > 0 ? llround(left) : 0;
+    }
+
+    /**
+     * Folds a finished burst into the prediction
+     * @param index
+     * @param runTime last part of the burst
+     */
+    void Observe(int index, int runTime) {
+        prediction[index] = alpha * (burstSoFar[index] + runTime) + (1 - alpha) * prediction[index];
+        burstSoFar[index] = 0;
+    }
+
+    std::vector<IndexedHeap> queues; //ready processes per CPU, keyed on Remaining()
+    std::vector<double> prediction; //predicted length of each process's next burst
+    std::vector<int> burstSoFar; //CPU time of the current burst before the latest interval
+    long long readyCount; //insertions so far (FIFO tie-break)
+    double alpha; //weight of the latest burst
+    int guess; //prediction before any burst was seen
+};
+
+/**
+ * Shortest remaining time next: predictive SPN which also preempts. When a
+ * process becomes ready, the running process on its CPU gives way if the
+ * shortest queued prediction is below what is predicted to remain of the
+ * running process's burst.
+ */
+class ShortestRemainingTimePolicy : public PredictiveShortestProcessNextPolicy {
+public:
+    static constexpr const char* NAME = "SRTN";
+    static constexpr bool PREEMPTIVE = true;
+
+    ShortestRemainingTimePolicy(const Scheduler::Options& options, const ProcessState& state)
+    : PredictiveShortestProcessNextPolicy(options, state) {}
+
+    bool preempts(int cpu, int index, int runTime) const {
+        if (queues[cpu].empty()) {
+            return false;
+        }
+        double left = prediction[index] - burstSoFar[index] - runTime;
+        return queues[cpu].key(queues[cpu].top()) < left;
+    }
+};
+
+/**
+ * Multi-level feedback queue: one FIFO queue per level per CPU, the highest
+ * non-empty level runs first. A process whose quantum ends drops a level,
+ * one which blocks keeps its level, and a periodic boost moves every process
+ * back to the top.
+ */
+class MultilevelFeedbackPolicy : public SchedulingPolicy {
+public:
+    static constexpr const char* NAME = "MLFQ";
+
+    MultilevelFeedbackPolicy(const Scheduler::Options& options, const ProcessState& state);
+
+    void enqueue(int cpu, int index) {
+        ++sizes[cpu];
+        queues[cpu * numLevels + Level(index)].push(index);
+    }
+
+    int pick_next(int cpu) {
+        if (sizes[cpu] == 0) {
+            return -1;
+        }
+        --sizes[cpu];
+        return FirstLevel(cpu)->pop();
+    }
+
+    int steal(int victim, int /*cpu*/) {
+        if (sizes[victim] == 0) {
+            return -1;
+        }
+        --sizes[victim];
+        return FirstLevel(victim)->pop_back();
+    }
+
+    int size(int cpu) const { return sizes[cpu]; }
+    int quantum(int /*cpu*/, int index) const { return quanta[Level(index)]; }
+    void describe(OutputWriter& out) const;
+    void save(CheckpointWriter& out) const;
+    void load(CheckpointReader& in);
+
+    void resize(int count) {
+        level.resize(count, 0);
+        levelEpoch.resize(count, 0);
+    }
+
+    void on_arrive(int index) {
+        level[index] = 0;
+        levelEpoch[index] = epoch;
+    }
+
+    /**
+     * If a boost is due, moves every process back to the highest level,
+     * keeping queued processes in level then FIFO order
+     * @param time
+     */
+    void on_tick(long long time) {
+        if (boostPeriod > 0 && time >= nextBoost) {
+            Boost(time);
+        }
+    }
+
+    /**
+     * Moves the process down one level
+     * @param index
+     * @param runTime
+     */
+    void on_expire(int index, int /*runTime*/) {
+        int current = Level(index);
+        level[index] = (current < numLevels - 1) ? current + 1 : current;
+        levelEpoch[index] = epoch;
+    }
+
+private:
+    int Level(int index) const { return levelEpoch[index] == epoch ? level[index] : 0; }
+
+    ReadyQueue* FirstLevel(int cpu) {
+        ReadyQueue* levels = &queues[cpu * numLevels];
+        while (levels->empty()) {
+            ++levels;
+        }
+        return levels;
+    }
+
+    void Boost(long long time);
+
+    std::vector<int> quanta; //quantum per level
+    int numLevels;
+    std::vector<int> sizes; //processes queued per CPU
+    std::vector<ReadyQueue> queues; //cpu * numLevels + level
+    std::vector<int> level; //level per process, valid if levelEpoch matches epoch
+    std::vector<int> levelEpoch; //boost epoch in which level was last set
+    int epoch; //number of boosts so far
+    long long boostPeriod; //0 for none
+    long long nextBoost; //time of the next boost
+};
+
+/**
+ * Completely fair: one red-black tree (std::set) per CPU ordered by
+ * vruntime, run time scaled by DEFAULT_WEIGHT / weight. A process runs for
+ * its weighted share of the target latency, but at least the minimum
+ * granularity.
+ */
+class CompletelyFairPolicy : public SchedulingPolicy {
+public:
+    static constexpr const char* NAME = "CFS";
+
+    CompletelyFairPolicy(const Scheduler::Options& options, const ProcessState& state_);
+
+    void enqueue(int cpu, int index);
+    int pick_next(int cpu);
+    int steal(int victim, int cpu);
+    int size(int cpu) const { return queues[cpu].size(); }
+    int quantum(int cpu, int index) const;
+    void describe(OutputWriter& out) const { out << granularity << " latency=" << latency; }
+    void save(CheckpointWriter& out) const;
+    void load(CheckpointReader& in);
+
+    void resize(int count) { vruntime.resize(count, 0); }
+    void on_arrive(int index) { vruntime[index] = 0; } //enqueue raises it to the CPU's floor
+    void on_block(int index, int runTime) { Charge(index, runTime); }
+    void on_expire(int index, int runTime) { Charge(index, runTime); }
+    void on_exit(int index, int runTime) { Charge(index, runTime); }
+
+private:
+    void Charge(int index, int runTime) {
+        vruntime[index] += (static_cast<long long> (runTime) << 20) / state.table.weight[index];
+    }
+
+    /**
+     * Removes the process with the smallest vruntime from a CPU's tree
+     * @param cpu
+     * @return process index
+     */
+    int TakeFirst(int cpu);
+
+    const ProcessState& state;
+    std::vector<std::set<std::tuple<long long, long long, int> > > queues; //(vruntime, readyCount, index) per CPU
+    std::vector<long long> vruntime; //per process, in 1/1024 time units
+    std::vector<long long> minVruntime; //per-CPU floor for queued vruntimes
+    std::vector<long long> queuedWeight; //total weight queued per CPU
+    long long readyCount; //insertions so far (FIFO tie-break)
+    int latency; //target latency
+    int granularity; //minimum granularity
+};
+
+/**
+ * Stride scheduling: each process holds tickets (its weight) and a pass
+ * value which grows by STRIDE1 / tickets for every time unit it runs. One
+ * heap per CPU keyed on pass; the smallest pass runs next for a fixed time
+ * slice, so shares are exact over time and the order is deterministic. A
+ * new process joins at the CPU's global pass plus one stride; a blocked one
+ * keeps the lead or lag it had over the global pass when it left.
+ */
+class StridePolicy : public SchedulingPolicy {
+public:
+    static constexpr const char* NAME = "STRIDE";
+    static const long long STRIDE1 = 1LL << 20; //pass per time unit of a process with one ticket
+
+    StridePolicy(const Scheduler::Options& options, const ProcessState& state_);
+
+    void enqueue(int cpu, int index);
+    int pick_next(int cpu);
+    int steal(int victim, int cpu);
+    int size(int cpu) const { return queues[cpu].size(); }
+    int quantum(int /*cpu*/, int /*index*/) const { return timeSlice; }
+    void describe(OutputWriter& out) const { out << timeSlice; }
+    void save(CheckpointWriter& out) const;
+    void load(CheckpointReader& in);
+
+    void resize(int count);
+    void on_arrive(int index) {
+        remain[index] = Stride(index, timeSlice);
+        away[index] = 1;
+    }
+    void on_block(int index, int runTime) {
+        pass[index] += Stride(index, runTime);
+        remain[index] = pass[index] - globalPass[state.last_cpu[index]];
+        away[index] = 1;
+    }
+    void on_expire(int index, int runTime) { pass[index] += Stride(index, runTime); }
+
+private:
+    /**
+     * @param index
+     * @param runTime
+     * @return pass a process gains by running for runTime
+     */
+    long long Stride(int index, int runTime) const {
+        return runTime * STRIDE1 / state.table.weight[index];
+    }
+
+    const ProcessState& state;
+    std::vector<IndexedHeap> queues; //ready processes per CPU, keyed on pass
+    std::vector<long long> pass; //per process
+    std::vector<long long> remain; //per process, pass - global pass when it left the CPU's queue
+    std::vector<char> away; //per process, 1 if it rejoins at the global pass plus remain
+    std::vector<long long> globalPass; //per CPU, pass of the process dispatched last
+    long long readyCount; //insertions so far (FIFO tie-break)
+    int timeSlice;
+};
+
+/**
+ * Lottery scheduling: each process holds tickets (its weight). One
+ * TicketTree per CPU over the tickets of its ready processes; the next
+ * process is the holder of a ticket drawn at random, O(log N), and runs for
+ * a fixed time slice, so shares are met in expectation. The draws come from
+ * a 64-bit Mersenne Twister seeded with options.lottery_seed, so a run can
+ * be repeated exactly.
+ */
+class LotteryPolicy : public SchedulingPolicy {
+public:
+    static constexpr const char* NAME = "LOTTERY";
+
+    LotteryPolicy(const Scheduler::Options& options, const ProcessState& state_);
+
+    void enqueue(int cpu, int index) {
+        trees[cpu].add(index, state.table.weight[index]);
+        ++sizes[cpu];
+    }
+    int pick_next(int cpu);
+    int steal(int victim, int /*cpu*/) { return pick_next(victim); }
+    int size(int cpu) const { return sizes[cpu]; }
+    int quantum(int /*cpu*/, int /*index*/) const { return timeSlice; }
+    void describe(OutputWriter& out) const { out << timeSlice << " seed=" << seed; }
+    void save(CheckpointWriter& out) const;
+    void load(CheckpointReader& in);
+
+    void resize(int count) {
+        for (TicketTree& tree : trees) {
+            tree.resize(count);
+        }
+    }
+
+private:
+    const ProcessState& state;
+    std::vector<TicketTree> trees; //tickets of the ready processes per CPU
+    std::vector<int> sizes; //ready processes per CPU
+    std::mt19937_64 random;
+    unsigned long long seed;
+    int timeSlice;
+};
+
+/**
+ * Earliest deadline first: one heap per CPU keyed on the absolute deadline
+ * (arrival + relative deadline), preemptive when processes arrive or
+ * unblock. Processes without a deadline, or whose deadline admission
+ * control refused, run in arrival order behind all others; no time slice.
+ */
+class EarliestDeadlinePolicy : public SchedulingPolicy {
+public:
+    static constexpr const char* NAME = "EDF";
+    static constexpr bool PREEMPTIVE = true;
+
+    EarliestDeadlinePolicy(const Scheduler::Options& options, const ProcessState& state_);
+
+    void enqueue(int cpu, int index) { queues[cpu].push(index, Deadline(index), readyCount++); }
+    int pick_next(int cpu) { return queues[cpu].empty() ? -1 : queues[cpu].pop(); }
+    int steal(int victim, int /*cpu*/) { return pick_next(victim); }
+    int size(int cpu) const { return queues[cpu].size(); }
+    int quantum(int /*cpu*/, int /*index*/) const { return 0; }
+    void describe(OutputWriter& out) const { out << "preemptive"; }
+    void save(CheckpointWriter& out) const;
+    void load(CheckpointReader& in);
+
+    void resize(int count) {
+        for (IndexedHeap& heap : queues) {
+            heap.resize(count);
+        }
+    }
+
+    bool preempts(int cpu, int index, int /*runTime*/) const {
+        return !queues[cpu].empty() && queues[cpu].key(queues[cpu].top()) < Deadline(index);
+    }
+
+private:
+    /**
+     * @param index
+     * @return absolute deadline, LLONG_MAX for none
+     */
+    long long Deadline(int index) const {
+        const ProcessTable& table = state.table;
+        if (table.deadline[index] == 0 || (state.flags[index] & ProcessState::REJECTED)) {
+            return LLONG_MAX;
+        }
+        return static_cast<long long> (table.arrival_time[index]) + table.deadline[index];
+    }
+
+    const ProcessState& state;
+    std::vector<IndexedHeap> queues; //ready processes per CPU, keyed on Deadline()
+    long long readyCount; //insertions so far (FIFO tie-break)
+};
+
+#endif /* POLICIES_H */
@@ -0,0 +1,80 @@
+/*
+ * File:   ProcessStream.cpp
+ */
+
+#include "ProcessStream.h"
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+#include <unistd.h>
+
+using std::cerr;
+
+ProcessStream::ProcessStream(int fd_, const std::string& name_)
+: fd(fd_), streamName(name_), buffer(1 << 16), start(0), end(0), eof(false), lineNumber(0),
+numErrors(0), lastArrival(0) {
+}
+
+bool ProcessStream::next(InputLine& line) {
+    while (true) {
+        const char* base = buffer.data();
+        const char* lineEnd = static_cast<const char*> (memchr(base + start, '\n', end - start));
+        if (lineEnd == nullptr && !eof) {
+            Fill();
+            continue;
+        }
+        if (lineEnd == nullptr && start == end) {
+            return false;
+        }
+        //the last line may have no newline
+        const char* lineStart = base + start;
+        if (lineEnd == nullptr) {
+            lineEnd = base + end;
+            start = end;
+        } else {
+            start = lineEnd + 1 - base;
+        }
+        ++lineNumber;
+
+        const char* error = InputLine::Parse(lineStart, lineEnd, line);
+        if (error == nullptr && line.name.empty()) { //blank line
+            continue;
+        }
+        if (error == nullptr && line.arrival_time < lastArrival) {
+            error = "arrival time earlier than previous line";
+        }
+        if (error != nullptr) {
+            cerr << "ERROR: " << streamName << ":" << lineNumber << ": " << error << ": "
+                    << std::string_view(lineStart, lineEnd - lineStart) << "\n";
+            ++numErrors;
+            continue;
+        }
+        lastArrival = line.arrival_time;
+        return true;
+    }
+}
+
+bool ProcessStream::Fill() {
+    //keep the unparsed part at the front, and make room if it fills the buffer
+    memmove(buffer.data(), buffer.data() + start, end - start);
+    end -= start;
+    start = 0;
+    if (end == buffer.size()) {
+        buffer.resize(buffer.size() * 2);
+    }
+    while (true) {
+        ssize_t count = read(fd, buffer.data() + end, buffer.size() - end);
+        if (count == -1 && errno == EINTR) {
+            continue;
+        }
+        if (count == -1) {
+            cerr << "ERROR: failure while reading file: " << streamName << "\n";
+            exit(2);
+        }
+        end += count;
+        eof = (count == 0);
+        return !eof;
+    }
+}
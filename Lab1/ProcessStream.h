@@ -0,0 +1,72 @@
+/*
+ * ProcessStream - reads Scheduler input lines lazily from a file descriptor
+ * 
+ * Used by the online mode, where the workload arrives on standard input and
+ * may be longer than memory: only a small read buffer is kept, and lines are
+ * parsed one at a time as the simulation needs them. Malformed lines are
+ * reported and skipped so the simulation can carry on; the caller checks
+ * errors() at the end.
+ */
+
+/*
+ * File:   ProcessStream.h
+ */
+
+#ifndef PROCESSSTREAM_H
+#define PROCESSSTREAM_H
+
+#include <string>
+#include <vector>
+
+#include "InputLine.h"
+
+class ProcessStream {
+public:
+    /**
+     * Constructor
+     * @param fd_ descriptor to read from (not closed by the stream)
+     * @param name_ name used in error messages
+     */
+    ProcessStream(int fd_, const std::string& name_);
+    ~ProcessStream() {}
+
+    ProcessStream(const ProcessStream &other) = delete;
+    ProcessStream(ProcessStream &&other) = delete;
+    ProcessStream operator=(const ProcessStream &other) = delete;
+    ProcessStream operator=(ProcessStream &&other) = delete;
+
+    /**
+     * Reads the next valid line, skipping blank lines and reporting
+     * malformed ones (including arrival times out of order) on cerr
+     * @param line receives the fields; line.name stays valid until the next call
+     * @return false at the end of the input
+     */
+    bool next(InputLine& line);
+
+    /**
+     * @return number of malformed lines so far
+     */
+    int errors() const { return numErrors; }
+
+    const std::string& name() const { return streamName; }
+
+private:
+    /**
+     * Reads more input after the unparsed part of the buffer, growing the
+     * buffer if a line does not fit; exits with status 2 on a read error
+     * @return false at the end of the input
+     */
+    bool Fill();
+
+    int fd; //descriptor read from
+    std::string streamName; //name for error messages
+    std::vector<char> buffer; //input read but not yet parsed is [start, end)
+    size_t start;
+    size_t end;
+    bool eof; //no more input after buffer
+    int lineNumber; //lines read so far
+    int numErrors; //malformed lines so far
+    long long lastArrival; //arrival time of the latest valid line
+};
+
+#endif /* PROCESSSTREAM_H */
@@ -0,0 +1,89 @@
+/*
+ * File:   ProcessTable.cpp
+ */
+
+#include "ProcessTable.h"
+
+#include <algorithm>
+
+void ProcessTable::reserve(int count) {
+    arrival_time.reserve(count);
+    total_time.reserve(count);
+    block_interval.reserve(count);
+    weight.reserve(count);
+    deadline.reserve(count);
+    name_id.reserve(count);
+    names.reserve(count);
+}
+
+void ProcessTable::move(int from, int to) {
+    std::vector<int>* columns[] = {&arrival_time, &total_time, &block_interval, &weight, &deadline, &name_id};
+    for (std::vector<int>* column : columns) {
+        auto begin = column->begin();
+        if (from < to) {
+            std::rotate(begin + from, begin + from + 1, begin + to + 1);
+        } else if (to < from) {
+            std::rotate(begin + to, begin + from, begin + from + 1);
+        }
+    }
+}
+
+void ProcessTable::save(CheckpointWriter& out) const {
+    out.put(arrival_time);
+    out.put(total_time);
+    out.put(block_interval);
+    out.put(weight);
+    out.put(deadline);
+    for (int i = 0; i < size(); ++i) {
+        out.put_string(name(i));
+    }
+}
+
+void ProcessTable::load(CheckpointReader& in) {
+    in.get(arrival_time);
+    in.get(total_time);
+    in.get(block_interval);
+    in.get(weight);
+    in.get(deadline);
+    name_id.resize(size());
+    names.reserve(size());
+    for (int i = 0; i < size(); ++i) {
+        name_id[i] = names.intern(in.get_string());
+    }
+}
+
+size_t ProcessTable::bytes() const {
+    return (arrival_time.capacity() + total_time.capacity() + block_interval.capacity() +
+            weight.capacity() + deadline.capacity() + name_id.capacity()) * sizeof (int) + names.bytes();
+}
+
+ProcessState::ProcessState(const ProcessTable &table_)
+: table(table_), remaining_time(table_.total_time), time_until_blocked(table_.block_interval),
+flags(table_.size(), 0), last_cpu(table_.size(), -1) {
+}
+
+void ProcessState::resize(int count) {
+    remaining_time.resize(count);
+    time_until_blocked.resize(count);
+    flags.resize(count);
+    last_cpu.resize(count);
+}
+
+void ProcessState::save(CheckpointWriter& out) const {
+    out.put(remaining_time);
+    out.put(time_until_blocked);
+    out.put(flags);
+    out.put(last_cpu);
+}
+
+void ProcessState::load(CheckpointReader& in) {
+    in.get(remaining_time);
+    in.get(time_until_blocked);
+    in.get(flags);
+    in.get(last_cpu);
+}
+
+size_t ProcessState::bytes() const {
+    return (remaining_time.capacity() + time_until_blocked.capacity() + last_cpu.capacity()) * sizeof (int) +
+            flags.capacity();
+}
@@ -0,0 +1,187 @@
+/*
+ * ProcessTable - structure-of-arrays storage for the Scheduler's processes
+ * 
+ * ProcessTable holds the workload read from the input file, one column per
+ * field, and is never modified by a simulation. ProcessState holds the
+ * columns a simulation updates, so each algorithm run gets its own state
+ * while sharing the same table. Process names are kept in a StringPool and
+ * referenced by id; the pool may point into the mapped input file, which the
+ * table keeps open.
+ */
+
+/*
+ * File:   ProcessTable.h
+ */
+
+#ifndef PROCESSTABLE_H
+#define PROCESSTABLE_H
+
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include "Checkpoint.h"
+#include "MappedFile.h"
+#include "StringPool.h"
+
+class ProcessTable {
+public:
+    static const int DEFAULT_WEIGHT = 1024; //weight of a process without a weight column
+
+    ProcessTable() {}
+    ~ProcessTable() {}
+
+    ProcessTable(const ProcessTable &other) = delete;
+    ProcessTable(ProcessTable &&other) = delete;
+    ProcessTable operator=(const ProcessTable &other) = delete;
+    ProcessTable operator=(ProcessTable &&other) = delete;
+
+    /**
+     * Appends a process to the table
+     * @param name id of the name in the names pool
+     * @param arrival
+     * @param total
+     * @param block
+     * @param weight_ share of the CPU relative to other processes (CFS)
+     * @param deadline_ time after arrival by which the process should finish, 0 for none
+     * @return index of the new process
+     */
+    int add(int name, int arrival, int total, int block, int weight_ = DEFAULT_WEIGHT, int deadline_ = 0) {
+        arrival_time.push_back(arrival);
+        total_time.push_back(total);
+        block_interval.push_back(block);
+        weight.push_back(weight_);
+        deadline.push_back(deadline_);
+        name_id.push_back(name);
+        return arrival_time.size() - 1;
+    }
+
+    /**
+     * Overwrites a row, for reusing the row of a process which terminated
+     * @param index
+     * @param name id of the name in the names pool
+     * @param arrival
+     * @param total
+     * @param block
+     * @param weight_
+     * @param deadline_
+     */
+    void set(int index, int name, int arrival, int total, int block, int weight_, int deadline_) {
+        arrival_time[index] = arrival;
+        total_time[index] = total;
+        block_interval[index] = block;
+        weight[index] = weight_;
+        deadline[index] = deadline_;
+        name_id[index] = name;
+    }
+
+    /**
+     * Moves a row to another position, shifting the rows in between by one
+     * (to keep the table in arrival order when an arrival time changes)
+     * @param from
+     * @param to
+     */
+    void move(int from, int to);
+
+    /**
+     * Reserves room for the given number of processes
+     * @param count
+     */
+    void reserve(int count);
+
+    int size() const { return arrival_time.size(); }
+
+    std::string_view name(int index) const { return names.get(name_id[index]); }
+
+    /**
+     * Writes every row, names included
+     * @param out
+     */
+    void save(CheckpointWriter& out) const;
+
+    /**
+     * Appends the rows written by save() to an empty table; names are copied
+     * into the pool
+     * @param in
+     */
+    void load(CheckpointReader& in);
+
+    /**
+     * @return approximate number of bytes used by the table
+     */
+    size_t bytes() const;
+
+    std::vector<int> arrival_time; //arrival time of process in system
+    std::vector<int> total_time; //total time needed for process to run
+    std::vector<int> block_interval; //interval of time process blocks for I/O
+    std::vector<int> weight; //CPU share, optional fifth input column
+    std::vector<int> deadline; //relative deadline, optional sixth input column (0 for none)
+    std::vector<int> name_id; //name of process in the string pool
+    StringPool names; //interned process names
+    std::unique_ptr<MappedFile> source; //mapped input file, names may point into it
+};
+
+/**
+ * Columns updated while a scheduling algorithm runs
+ */
+struct ProcessState {
+    /**
+     * Constructor - set every process to its initial state
+     * @param table
+     */
+    ProcessState(const ProcessTable &table);
+
+    /**
+     * Length of the next CPU burst: the time until the process blocks or
+     * terminates, whichever is shorter (block_interval 0 never blocks)
+     * Used as the SPN priority key
+     * @param index
+     * @return 
+     */
+    int NextBurst(int index) const {
+        if (table.block_interval[index] > 0 && time_until_blocked[index] < remaining_time[index]) {
+            return time_until_blocked[index];
+        }
+        return remaining_time[index];
+    }
+
+    /**
+     * Adds or removes rows; new rows must be initialized with reset()
+     * @param count
+     */
+    void resize(int count);
+
+    /**
+     * Sets a row to the initial state of the table's process
+     * @param index
+     */
+    void reset(int index) {
+        remaining_time[index] = table.total_time[index];
+        time_until_blocked[index] = table.block_interval[index];
+        flags[index] = 0;
+        last_cpu[index] = -1;
+    }
+
+    int size() const { return remaining_time.size(); }
+
+    void save(CheckpointWriter& out) const;
+    void load(CheckpointReader& in);
+
+    /**
+     * @return approximate number of bytes used by the state columns
+     */
+    size_t bytes() const;
+
+    //flag bits
+    static const unsigned char BLOCKED = 1; //waiting for I/O
+    static const unsigned char TERMINATED = 2; //finished running
+    static const unsigned char REJECTED = 4; //deadline refused by admission control, runs best effort
+
+    const ProcessTable &table; //workload the state belongs to
+    std::vector<int> remaining_time; //CPU time still needed
+    std::vector<int> time_until_blocked; //CPU time left before the process blocks for I/O
+    std::vector<unsigned char> flags; //BLOCKED / TERMINATED bits
+    std::vector<int> last_cpu; //CPU the process last ran on, -1 before its first dispatch
+};
+
+#endif /* PROCESSTABLE_H */
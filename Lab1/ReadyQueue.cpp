@@ -0,0 +1,41 @@
+/*
+ * File:   ReadyQueue.cpp
+ */
+
+#include "ReadyQueue.h"
+
+ReadyQueue::ReadyQueue(int capacity_)
+: slots(capacity_ > 0 ? capacity_ : 1), capacity(capacity_ > 0 ? capacity_ : 1),
+head(0), tail(0), count(0) {
+}
+
+void ReadyQueue::Grow() {
+    //unwrap the ring into a buffer of twice the size
+    std::vector<int> larger(capacity * 2);
+    for (int i = 0; i < count; ++i) {
+        larger[i] = slots[(head + i) % capacity];
+    }
+    slots.swap(larger);
+    capacity *= 2;
+    head = 0;
+    tail = count;
+}
+
+void ReadyQueue::save(CheckpointWriter& out) const {
+    std::vector<int> contents(count);
+    for (int i = 0; i < count; ++i) {
+        contents[i] = slots[(head + i) % capacity];
+    }
+    out.put(contents);
+}
+
+void ReadyQueue::load(CheckpointReader& in) {
+    std::vector<int> contents;
+    in.get(contents);
+    head = 0;
+    tail = 0;
+    count = 0;
+    for (int index : contents) {
+        push(index);
+    }
+}
@@ -0,0 +1,92 @@
+/*
+ * ReadyQueue - FIFO queue of process indices for the Scheduler
+ * 
+ * Implemented as a ring buffer: a process can be in the ready queue at most
+ * once, so a capacity equal to the number of processes is enough and push/pop
+ * never allocate. A queue created smaller (one per CPU) doubles its capacity
+ * when it fills up. Processes can also be taken from the back of the queue,
+ * for work stealing.
+ */
+
+/*
+ * File:   ReadyQueue.h
+ */
+
+#ifndef READYQUEUE_H
+#define READYQUEUE_H
+
+#include <vector>
+
+#include "Checkpoint.h"
+
+class ReadyQueue {
+public:
+    /**
+     * Constructor - allocate room for the given number of processes
+     * @param capacity maximum number of indices held at once
+     */
+    ReadyQueue(int capacity);
+    ~ReadyQueue() {}
+
+    /**
+     * Appends a process index to the end of the queue
+     * @param index
+     */
+    void push(int index) {
+        if (count == capacity) {
+            Grow();
+        }
+        slots[tail] = index;
+        tail = (tail + 1 == capacity) ? 0 : tail + 1;
+        ++count;
+    }
+
+    /**
+     * Removes and returns the index at the front of the queue
+     * (queue must not be empty)
+     * @return 
+     */
+    int pop() {
+        int index = slots[head];
+        head = (head + 1 == capacity) ? 0 : head + 1;
+        --count;
+        return index;
+    }
+
+    /**
+     * Removes and returns the index at the back of the queue
+     * (queue must not be empty)
+     * @return 
+     */
+    int pop_back() {
+        tail = (tail == 0) ? capacity - 1 : tail - 1;
+        --count;
+        return slots[tail];
+    }
+
+    bool empty() const { return count == 0; }
+    int size() const { return count; }
+
+    /**
+     * Writes the queued indices front to back
+     * @param out
+     */
+    void save(CheckpointWriter& out) const;
+
+    /**
+     * Replaces the contents with the indices written by save()
+     * @param in
+     */
+    void load(CheckpointReader& in);
+
+private:
+    std::vector<int> slots; //ring buffer storage
+    int capacity; //number of slots
+    int head; //position of the front of the queue
+    int tail; //position one past the back of the queue
+    int count; //number of indices in the queue
+
+    void Grow();
+};
+
+#endif /* READYQUEUE_H */
@@ -6,351 +6,1115 @@
  */
 
 #include "Scheduler.h"
+#include "Arrivals.h"
+#include "Benchmark.h"
+#include "GreenRuntime.h"
+#include "InputLine.h"
+#include "Policies.h"
+#include "ShareMonitor.h"
+#include "ThreadPool.h"
 
+#include <chrono>
 #include <iostream>
 #include <iomanip>
-#include <sstream>
 #include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+#include <unordered_map>
+
+#include <unistd.h>
 
 using std::cin;
 using std::cout;
 using std::cerr;
-using std::getline;
-using std::istringstream;
 using std::string;
 using std::vector;
-using std::ifstream;
+
+volatile sig_atomic_t Scheduler::checkpointSignal = 0;
 
 Scheduler::Scheduler(std::string file_name_, int block_duration, int time_slice) {
     BLOCK_DURATION = block_duration;
     TIME_SLICE = time_slice;
-    ParseFile(file_name_);
-    Execute(ParseFile(file_name_));
+    options.block_duration = block_duration;
+    options.time_slice = time_slice;
+    ParseFile(file_name_, processes);
+    Execute(processes);
+}
+
+Scheduler::Scheduler(std::string file_name_, const Options& options_) : options(options_) {
+    BLOCK_DURATION = options.block_duration;
+    TIME_SLICE = options.time_slice;
+    if (!options.trace_file.empty()) {
+        trace.reset(new TraceWriter(options.trace_file));
+    }
+    if (file_name_ == "-") {
+        ExecuteOnline();
+        return;
+    }
+    ParseFile(file_name_, processes);
+    Execute(processes);
+}
+
+Scheduler::Scheduler(std::string file_name_) {
+    BLOCK_DURATION = 0;
+    TIME_SLICE = 0;
+    ParseFile(file_name_, processes);
+}
+
+Scheduler::Scheduler(const std::string& checkpoint_file, const std::vector<int>& time_slices) {
+    CheckpointReader in(checkpoint_file);
+    Options saved = LoadOptions(in);
+    processes.load(in);
+    size_t runState = in.tell(); //every continuation reads the run's state from here
+    std::vector<int> slices = time_slices.empty() ? std::vector<int>(1, saved.time_slice) : time_slices;
+    for (int slice : slices) {
+        options = saved;
+        options.time_slice = slice;
+        if (slices.size() > 1) { //forks would overwrite each other's checkpoints
+            options.checkpoint_file.clear();
+        } else if (!options.checkpoint_file.empty()) {
+            CatchCheckpointSignals();
+        }
+        BLOCK_DURATION = options.block_duration;
+        TIME_SLICE = options.time_slice;
+        {
+            in.seek(runState);
+            TableArrivals arrivals(processes);
+            OutputWriter out(STDOUT_FILENO);
+            Run(arrivals, options.policies.front(), options, &out, &in);
+        }
+        //then the policies which had not started yet, from the beginning
+        options.policies.erase(options.policies.begin());
+        Execute(processes);
+    }
 }
 
 Scheduler::~Scheduler() {
 }
 
-std::vector<Scheduler::Process> Scheduler::ParseFile(std::string file_name_) {
-    vector<Scheduler::Process> processes;
-    ifstream inputFileStream; //input file stream
-    /****
-     * TODO:
-     * - Read input file and extract data
-     * - Create std::vector of processes contained all processes that
-     *   need to be run (all process variables having been filled with data 
-     *   from input file
-     *****/
-    string line; //line we will send to Execute()
-    Process temp;
-    inputFileStream.open(file_name_);
-
-    if (inputFileStream.fail()) {
-        cerr << "ERROR: file not found: " << file_name_ << "\n";
-        exit(2);
+void Scheduler::ParseFile(std::string file_name_, ProcessTable& table) {
+    table.source.reset(new MappedFile(file_name_));
+    const char* p = table.source->data();
+    const char* end = p + table.source->size();
+
+    //size the columns up front from the number of lines
+    int numLines = 0;
+    for (const char* q = p; q != end && (q = static_cast<const char*> (memchr(q, '\n', end - q))) != nullptr; ++q) {
+        ++numLines;
+    }
+    table.reserve(numLines + 1);
+
+    int lineNumber = 0;
+    int numErrors = 0;
+    while (p != end) {
+        ++lineNumber;
+        const char* lineEnd = static_cast<const char*> (memchr(p, '\n', end - p));
+        if (lineEnd == nullptr) {
+            lineEnd = end;
+        }
+        const char* lineStart = p;
+        p = (lineEnd == end) ? end : lineEnd + 1;
+
+        InputLine line;
+        const char* error = InputLine::Parse(lineStart, lineEnd, line);
+        if (error == nullptr && line.name.empty()) { //blank line
+            continue;
+        }
+        if (error == nullptr && table.size() > 0 && line.arrival_time < table.arrival_time.back()) {
+            error = "arrival time earlier than previous line";
+        }
+        if (error != nullptr) {
+            cerr << "ERROR: " << file_name_ << ":" << lineNumber << ": " << error << ": "
+                    << std::string_view(lineStart, lineEnd - lineStart) << "\n";
+            ++numErrors;
+            continue;
+        }
+        table.add(table.names.add_view(line.name), line.arrival_time, line.total_time, line.block_interval,
+                line.weight, line.deadline);
     }
-    //While our file has another line, execute that line
-    while (getline(inputFileStream, line)) {
-        vector <string> tokens;
-        // stringstream class check1
-        istringstream check1(line);
-        string intermediate;
-        // Tokenizing w.r.t. space ' '
-        while (getline(check1, intermediate, ' ')) {
-            tokens.push_back(intermediate);
-        }
-        // get each character and store it into process        
-        temp.name = tokens[0];
-        temp.arrival_time = stoi(tokens[1]);
-        temp.total_time = stoi(tokens[2]);
-        temp.remaining_time = stoi(tokens[2]);
-        temp.block_interval = stoi(tokens[3]);
-        temp.termination_time = -1; //indicating the process has not terminated, needs to be updated when process completes
-        temp.is_blocked = false;
-        temp.time_blocked = temp.block_interval;
-        temp.time_until_blocked = temp.block_interval;
-        processes.push_back(temp);
-    }
-
-    // If terminated for reason other than end of file
-    if (!inputFileStream.eof()) {
-        std::cerr << "ERROR: failure while reading file: " << file_name_ << "\n";
+
+    if (numErrors > 0) {
+        cerr << "ERROR: " << numErrors << " malformed line(s) in file: " << file_name_ << "\n";
         exit(2);
     }
+}
+
+const char* Scheduler::PolicyName(Policy policy) {
+    switch (policy) {
+        case ROUND_ROBIN:
+            return RoundRobinPolicy::NAME;
+        case SHORTEST_PROCESS_NEXT:
+            return ShortestProcessNextPolicy::NAME;
+        case PREDICTIVE_SPN:
+            return PredictiveShortestProcessNextPolicy::NAME;
+        case SHORTEST_REMAINING_TIME:
+            return ShortestRemainingTimePolicy::NAME;
+        case EARLIEST_DEADLINE:
+            return EarliestDeadlinePolicy::NAME;
+        case STRIDE:
+            return StridePolicy::NAME;
+        case LOTTERY:
+            return LotteryPolicy::NAME;
+        case MULTILEVEL_FEEDBACK:
+            return MultilevelFeedbackPolicy::NAME;
+        default:
+            return CompletelyFairPolicy::NAME;
+    }
+}
 
-    inputFileStream.close();
+bool Scheduler::UsesTimeSlice(Policy policy) {
+    return policy == ROUND_ROBIN || policy == MULTILEVEL_FEEDBACK || policy == COMPLETELY_FAIR ||
+            policy == STRIDE || policy == LOTTERY;
+}
+
+bool Scheduler::SliceIsQuantum(Policy policy, const Options& options) {
+    return policy == ROUND_ROBIN || policy == LOTTERY ||
+            (policy == MULTILEVEL_FEEDBACK && options.mlfq_quanta.empty()); //nothing is demoted before a cut
+}
 
-    /* Confirms file sets process list correctly
-    for(int i = 0; i < processes.size(); ++i){
-        cout << "Process " << processes.at(i).name << " has arrival time " << processes.at(i).arrival_time;
-        cout << " blocking time " << processes.at(i).block_interval << " total time " << processes.at(i).total_time << std::endl;
+void Scheduler::Execute(const ProcessTable& processes) {
+    OutputWriter out(STDOUT_FILENO);
+    if (!options.checkpoint_file.empty()) {
+        CatchCheckpointSignals();
     }
-     */
-    return processes;
+    //each run sees the policies from its own on, so its checkpoints know what is left to run
+    Options run = options;
+    for (Policy policy : options.policies) {
+        switch (policy) {
+            case ROUND_ROBIN:
+                RoundRobin(processes, run, &out);
+                break;
+            case SHORTEST_PROCESS_NEXT:
+                ShortestProcessNext(processes, run, &out);
+                break;
+            case PREDICTIVE_SPN:
+                PredictiveShortestProcessNext(processes, run, &out);
+                break;
+            case SHORTEST_REMAINING_TIME:
+                ShortestRemainingTime(processes, run, &out);
+                break;
+            case EARLIEST_DEADLINE:
+                EarliestDeadlineFirst(processes, run, &out);
+                break;
+            case STRIDE:
+                StrideScheduling(processes, run, &out);
+                break;
+            case LOTTERY:
+                LotteryScheduling(processes, run, &out);
+                break;
+            case MULTILEVEL_FEEDBACK:
+                MultilevelFeedback(processes, run, &out);
+                break;
+            case COMPLETELY_FAIR:
+                CompletelyFair(processes, run, &out);
+                break;
+        }
+        run.policies.erase(run.policies.begin());
+    }
+}
+
+void Scheduler::CatchCheckpointSignals() {
+    struct sigaction action = {};
+    action.sa_handler = RequestCheckpoint;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGUSR1, &action, nullptr);
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+}
+
+void Scheduler::RequestCheckpoint(int signal) {
+    checkpointSignal = signal;
 }
 
-void Scheduler::Execute(std::vector<Scheduler::Process> processes) {
-    RoundRobin(processes);
-    //process objects are reset by the AverageTurnaroundTime function
-    ShortestProcessNext(processes);
+void Scheduler::SaveOptions(CheckpointWriter& out, const Options& options) {
+    out.put(options.block_duration);
+    out.put(options.time_slice);
+    out.put(options.cpus);
+    out.put(options.migration_cost);
+    out.put(options.policies);
+    out.put(options.mlfq_quanta);
+    out.put(options.mlfq_boost);
+    out.put(options.cfs_latency);
+    out.put(options.burst_alpha);
+    out.put(options.burst_guess);
+    out.put(options.admission_control);
+    out.put(options.lottery_seed);
+    out.put(options.share_window);
+    out.put(options.io_devices);
+    out.put(options.io_discipline);
+    out.put(options.io_seek);
+    out.put(options.switch_cost);
+    out.put(options.cache_penalty);
+    out.put(options.cache_decay);
+    out.put(options.summary_only);
+    out.put_string(options.checkpoint_file);
+    out.put(options.checkpoint_every);
 }
 
-void Scheduler::RoundRobin(std::vector<Scheduler::Process> processes) {
-    int time = 0;
-    int currentIndex = 0;
-    int numProcesses = processes.size();
-    int currentIntervalTime = 0;
-    bool switched = false;
-    bool complete = false;
-    int numBlocked = 0;
-    int count;
-    int activeProcesses = 0;
-    bool wasIdle = false;
-    Scheduler::Process* temp;
-    Process* currentProcess;
-
-    cout << "RR " << BLOCK_DURATION << " " << TIME_SLICE << std::endl;
-
-    //wait until a process arrives 
-    bool running = false;
-    while (!running) {
-        for (int i = 0; i < numProcesses; ++i) {
-            if (processes.at(i).arrival_time == time) {
-                currentProcess = &processes.at(i);
-                running = true;
-                currentIndex = i;
-                ++activeProcesses;
+Scheduler::Options Scheduler::LoadOptions(CheckpointReader& in) {
+    Options options;
+    options.block_duration = in.get<int>();
+    options.time_slice = in.get<int>();
+    options.cpus = in.get<int>();
+    options.migration_cost = in.get<int>();
+    in.get(options.policies);
+    in.get(options.mlfq_quanta);
+    options.mlfq_boost = in.get<int>();
+    options.cfs_latency = in.get<int>();
+    options.burst_alpha = in.get<double>();
+    options.burst_guess = in.get<int>();
+    options.admission_control = in.get<bool>();
+    options.lottery_seed = in.get<unsigned long long>();
+    options.share_window = in.get<long long>();
+    options.io_devices = in.get<int>();
+    options.io_discipline = in.get<IoDevices::Discipline>();
+    options.io_seek = in.get<int>();
+    options.switch_cost = in.get<int>();
+    options.cache_penalty = in.get<int>();
+    options.cache_decay = in.get<int>();
+    options.summary_only = in.get<bool>();
+    options.checkpoint_file = in.get_string();
+    options.checkpoint_every = in.get<long long>();
+    if (options.policies.empty() || options.cpus <= 0 || options.io_devices < 0) {
+        std::cerr << "ERROR: not a valid checkpoint file\n";
+        exit(2);
+    }
+    return options;
+}
+
+void Scheduler::ExecuteOnline() {
+    ProcessStream stream(STDIN_FILENO, "<stdin>");
+    {
+        StreamArrivals arrivals(stream);
+        OutputWriter out(STDOUT_FILENO);
+        Run(arrivals, options.policies.front(), options, &out);
+    }
+    if (stream.errors() > 0) {
+        cerr << "ERROR: " << stream.errors() << " malformed line(s) in file: " << stream.name() << "\n";
+        exit(2);
+    }
+}
+
+void Scheduler::Sweep(const std::vector<int>& block_durations, const std::vector<int>& time_slices,
+        const std::vector<int>& cpus, const Options& options) {
+    //one job per (block duration, cpus, policy, time slice) point, or per (block duration, cpus, policy)
+    //for policies without a time slice
+    struct Job {
+        Policy policy;
+        int block_duration;
+        int time_slice; //-1 if the policy has none
+        int cpus;
+    };
+    vector<Job> jobs;
+    for (int block : block_durations) {
+        for (int numCpus : cpus) {
+            for (Policy policy : options.policies) {
+                if (!UsesTimeSlice(policy)) {
+                    jobs.push_back({policy, block, -1, numCpus});
+                    continue;
+                }
+                for (int slice : time_slices) {
+                    jobs.push_back({policy, block, slice, numCpus});
+                }
             }
         }
-        ++time;
-        ++currentIntervalTime;
-    }
-
-    while (!complete) {
-        //Update blocked Processes
-        if (numBlocked != 0) {
-            for (int i = 0; i < numProcesses; ++i) {
-                temp = &processes.at(i);
-                if (temp->is_blocked) {
-                    temp->time_blocked -= 1;
-                    if (temp->time_blocked <= 0) {
-                        temp->is_blocked = false;
-                        temp->time_blocked = temp->block_interval;
-                        if (numBlocked == activeProcesses) { //system was idle
-                            cout << " " << (time - currentIntervalTime) << "\t<idle>\t" << +currentIntervalTime << "\tI" << std::endl;
-                            currentIntervalTime = 0;
-                            wasIdle = true;
-                        }
-                        --numBlocked;
-                    }
+    }
+    int numJobs = jobs.size();
+
+    //time slice lanes which only cap bursts fork from the run of the largest slice of their point
+    vector<int> base(numJobs, -1); //job a lane forks from, -1 for jobs which run on their own
+    vector<SnapshotLog> logs(numJobs);
+    long long lastArrival = (processes.size() > 0) ? processes.arrival_time.back() : 0;
+    for (SnapshotLog& log : logs) {
+        log.every = lastArrival / SWEEP_SNAPSHOTS + 1;
+        log.limit = 0; //raised to the largest slice forking from it
+        log.latest = true;
+    }
+    for (int job = 0; job < numJobs; ++job) {
+        const Job& j = jobs[job];
+        if (j.time_slice == -1 || !SliceIsQuantum(j.policy, options)) {
+            continue;
+        }
+        int largest = job;
+        for (int other = 0; other < numJobs; ++other) {
+            const Job& o = jobs[other];
+            if (o.policy == j.policy && o.block_duration == j.block_duration && o.cpus == j.cpus &&
+                    o.time_slice > jobs[largest].time_slice) {
+                largest = other;
+            }
+        }
+        base[job] = largest;
+        if (largest != job) {
+            logs[largest].limit = std::max(logs[largest].limit, static_cast<long long> (j.time_slice));
+        }
+    }
+    vector<int> bases; //jobs of the first round: all but the lanes
+    vector<int> lanes; //jobs of the second round, forking from their base
+    for (int job = 0; job < numJobs; ++job) {
+        if (base[job] == -1 || base[job] == job) {
+            bases.push_back(job);
+        } else {
+            lanes.push_back(job);
+        }
+    }
+
+    vector<RunStats> results(numJobs);
+    ThreadPool pool(options.num_threads);
+    auto settings = [&](int job) {
+        Options run = options;
+        run.block_duration = jobs[job].block_duration;
+        run.cpus = jobs[job].cpus;
+        if (jobs[job].time_slice != -1) {
+            run.time_slice = jobs[job].time_slice;
+        }
+        return run;
+    };
+    pool.run(bases.size(), [&](int b) {
+        int job = bases[b];
+        TableArrivals arrivals(processes);
+        results[job] = Run(arrivals, jobs[job].policy, settings(job), nullptr, nullptr,
+                logs[job].limit > 0 ? &logs[job] : nullptr);
+    });
+    pool.run(lanes.size(), [&](int l) {
+        int job = lanes[l];
+        const SnapshotLog& log = logs[base[job]];
+        if (log.longest_burst <= jobs[job].time_slice) { //never cut a burst: the same run
+            results[job] = results[base[job]];
+            return;
+        }
+        if (log.snapshots.empty()) { //nothing to fork from
+            results[job] = Simulate(processes, jobs[job].policy, settings(job), nullptr);
+            return;
+        }
+        int use = 0; //the last snapshot before this lane's first cut
+        while (use + 1 < static_cast<int> (log.snapshots.size()) &&
+                log.snapshots[use + 1].longest_burst <= jobs[job].time_slice) {
+            ++use;
+        }
+        CheckpointReader in(log.snapshots[use].state);
+        TableArrivals arrivals(processes);
+        results[job] = Run(arrivals, jobs[job].policy, settings(job), nullptr, &in);
+    });
+
+    cout << "ALG\tBLOCK\tSLICE\tCPUS\tDONE\tAVG_TURNAROUND\tMAX_TURNAROUND\tUTILIZATION\tSWITCHES\tMIGRATIONS"
+            "\tP99_TURNAROUND\tAVG_WAITING\tAVG_RESPONSE\tOVERHEAD\tMISSED\n";
+    for (int job = 0; job < numJobs; ++job) {
+        const RunStats& r = results[job];
+        const Job& j = jobs[job];
+        cout << PolicyName(j.policy) << "\t" << j.block_duration << "\t";
+        if (j.time_slice != -1) {
+            cout << j.time_slice;
+        } else {
+            cout << "-";
+        }
+        double capacity = static_cast<double> (r.finish_time) * j.cpus;
+        cout << "\t" << j.cpus << "\t" << r.finish_time << "\t" << r.average_turnaround
+                << "\t" << r.max_turnaround << "\t" << (capacity > 0 ? r.busy_time / capacity : 1.0)
+                << "\t" << r.dispatches << "\t" << r.migrations << "\t" << r.turnaround.percentile(99)
+                << "\t" << r.waiting.mean() << "\t" << r.response.mean()
+                << "\t" << (capacity > 0 ? (r.switch_time + r.cache_time) / capacity : 0.0) << "\t";
+        if (r.deadlines > 0) {
+            cout << r.missed / static_cast<double> (r.deadlines) << "\n";
+        } else {
+            cout << "-\n";
+        }
+    }
+    cout.flush();
+}
+
+void Scheduler::TimeRuns(const Options& options) {
+    for (Policy policy : options.policies) {
+        auto start = std::chrono::steady_clock::now();
+        RunStats stats = Simulate(processes, policy, options, nullptr);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        long long events = processes.size() + stats.blocks + stats.dispatches;
+        cout << PolicyName(policy) << "\t" << processes.size() << "\t" << events << "\t" << seconds
+                << "\t" << events / seconds << "\t" << Benchmark::PeakRss() << std::endl;
+    }
+}
+
+void Scheduler::TimeGreenThreads(const Options& options, long long unit_ns, const char* mix) {
+    GreenRuntime runtime(processes, options, unit_ns);
+    for (Policy policy : options.policies) {
+        GreenRuntime::Result real = runtime.Run(policy);
+        RunStats simulated = Simulate(processes, policy, options, nullptr);
+        cout << mix << "\t" << PolicyName(policy) << "\t" << options.cpus << "\t" << processes.size() << "\t"
+                << real.switches << "\t" << real.switch_ns << "\t" << real.preemptions << "\t" << real.seconds
+                << "\t" << processes.size() / real.seconds << "\t" << real.average_turnaround << "\t"
+                << simulated.average_turnaround << std::endl;
+    }
+}
+
+void Scheduler::WhatIf(const Options& options, int num_snapshots) {
+    Options run = options;
+    run.checkpoint_file.clear();
+    int numPolicies = options.policies.size();
+    long long lastArrival = (processes.size() > 0) ? processes.arrival_time.back() : 0;
+    vector<SnapshotLog> logs(numPolicies);
+    vector<RunStats> baselines(numPolicies);
+    cout << "ALG\tCHANGE\tRESUMED\tAVG_TURNAROUND\tDELTA\tSECONDS\n";
+    for (int p = 0; p < numPolicies; ++p) {
+        logs[p].every = lastArrival / num_snapshots + 1;
+        auto start = std::chrono::steady_clock::now();
+        TableArrivals arrivals(processes);
+        baselines[p] = Run(arrivals, options.policies[p], run, nullptr, nullptr, &logs[p]);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        cout << PolicyName(options.policies[p]) << "\t<baseline>\t0\t" << baselines[p].average_turnaround
+                << "\t0\t" << seconds << std::endl;
+    }
+
+    std::unordered_map<std::string_view, int> byName; //first process of each name
+    for (int i = processes.size() - 1; i >= 0; --i) {
+        byName[processes.name(i)] = i;
+    }
+    string line;
+    while (std::getline(cin, line)) {
+        std::istringstream words(line);
+        string word;
+        string label; //the line with single spaces, for the CHANGE column
+        while (words >> word) {
+            label += (label.empty() ? "" : " ") + word;
+        }
+        if (label.empty()) {
+            continue;
+        }
+        int slice = options.time_slice;
+        int from = -1; //row of the changed process, -1 for a new time slice
+        InputLine change;
+        const char* error = nullptr;
+        if (label.compare(0, 6, "slice ") == 0) {
+            std::istringstream value(label.substr(6));
+            if (!(value >> slice) || !value.eof() || slice <= 0) {
+                error = "invalid time slice";
+            }
+        } else {
+            error = InputLine::Parse(line.data(), line.data() + line.size(), change);
+            if (error == nullptr) {
+                auto found = byName.find(change.name);
+                if (found == byName.end()) {
+                    error = "no process of that name";
+                } else {
+                    from = found->second;
                 }
             }
         }
+        if (error != nullptr) {
+            cerr << "ERROR: " << error << ": " << label << "\n";
+            continue;
+        }
 
-        if (numBlocked != activeProcesses && !wasIdle) { //system is not idle
-            //check for current process termination
-            //switch processes and put currentProcess on completed list
-            if ((currentProcess->remaining_time == currentIntervalTime)) { //process is terminated
-                currentProcess->termination_time = time;
-                cout << " " << (time - currentIntervalTime) << "\t" << currentProcess->name << "\t" << currentProcess->remaining_time << "\tT" << std::endl;
-                currentProcess->remaining_time = 0;
-                currentIntervalTime = 0;
-                --activeProcesses;
-                switched = true;
-            } else if (currentIntervalTime == currentProcess->time_blocked) { //process is blocking
-                currentProcess->is_blocked = true;
-                currentProcess->remaining_time -= currentIntervalTime;
-                currentProcess->time_blocked = BLOCK_DURATION;
-                cout << " " << (time - currentIntervalTime) << "\t" << currentProcess->name << "\t" << +currentIntervalTime << "\tB" << std::endl;
-                currentIntervalTime = 0;
-                ++numBlocked;
-                switched = true;
-            } else if (currentIntervalTime == TIME_SLICE) { //time slice occurs
-                currentProcess->remaining_time -= TIME_SLICE;
-                currentProcess->time_blocked -= TIME_SLICE;
-                cout << " " << (time - currentIntervalTime) << "\t" << currentProcess->name << "\t" << +currentIntervalTime << "\tS" << std::endl;
-                currentIntervalTime = 0;
-                switched = true;
+        //change the table in place, moving the row to keep arrival order, and put it back after
+        int to = from;
+        InputLine old;
+        long long divergence = LLONG_MAX; //earliest time the change can make a difference
+        if (from != -1) {
+            old.arrival_time = processes.arrival_time[from];
+            old.total_time = processes.total_time[from];
+            old.block_interval = processes.block_interval[from];
+            old.weight = processes.weight[from];
+            old.deadline = processes.deadline[from];
+            const vector<int>& arrival = processes.arrival_time;
+            if (change.arrival_time >= old.arrival_time) {
+                to = std::upper_bound(arrival.begin() + from + 1, arrival.end(), change.arrival_time) - arrival.begin() - 1;
+            } else {
+                to = std::upper_bound(arrival.begin(), arrival.begin() + from, change.arrival_time) - arrival.begin();
             }
+            processes.move(from, to);
+            processes.set(to, processes.name_id[to], change.arrival_time, change.total_time, change.block_interval,
+                    change.weight, change.deadline);
+            divergence = std::min(old.arrival_time, change.arrival_time);
+        }
 
-            //process switching
-            if (switched && activeProcesses != 0) {
-                count = 0;
-                getNextIndex(currentIndex, numProcesses);
-                currentProcess = &processes.at(currentIndex);
-                //Search through all processes to find one that is not blocked, is past it's arrival time, and has not terminated
-                for (int i = 0; i < processes.size(); ++i) {
-                    if (currentProcess->termination_time == -1) { //process hasn't finished
-                        if (!currentProcess->is_blocked) { //process isn't blocked
-                            if (currentProcess->arrival_time < time) { //process has arrived
-                                break; //successfully found a runnable process
-                            }
-                        }
+        for (int p = 0; p < numPolicies; ++p) {
+            Policy policy = options.policies[p];
+            const vector<Snapshot>& snapshots = logs[p].snapshots;
+            //the processes after the cursor of a snapshot up to the divergence have not arrived
+            int use = -1; //snapshot to resume from, -1 if the baseline still holds
+            if (from != -1) {
+                while (use + 1 < static_cast<int> (snapshots.size()) && snapshots[use + 1].time <= divergence) {
+                    ++use;
+                }
+            } else if (slice != options.time_slice && UsesTimeSlice(policy) && !snapshots.empty()) {
+                use = 0;
+                if (SliceIsQuantum(policy, options)) { //same decisions until a burst longer than either slice
+                    int shorter = std::min(slice, options.time_slice);
+                    while (use + 1 < static_cast<int> (snapshots.size()) &&
+                            snapshots[use + 1].longest_burst <= shorter) {
+                        ++use;
                     }
-                    getNextIndex(currentIndex, numProcesses);
-                    currentProcess = &processes.at(currentIndex);
                 }
+            }
+            RunStats stats = baselines[p];
+            double seconds = 0;
+            if (use != -1) {
+                run.time_slice = slice;
+                auto start = std::chrono::steady_clock::now();
+                CheckpointReader in(snapshots[use].state);
+                TableArrivals arrivals(processes);
+                stats = Run(arrivals, policy, run, nullptr, &in);
+                seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                run.time_slice = options.time_slice;
+            }
+            cout << PolicyName(policy) << "\t" << label << "\t";
+            if (use != -1) {
+                cout << snapshots[use].time;
+            } else {
+                cout << "-";
+            }
+            cout << "\t" << stats.average_turnaround << "\t"
+                    << stats.average_turnaround - baselines[p].average_turnaround << "\t" << seconds << std::endl;
+        }
+
+        if (from != -1) {
+            processes.set(to, processes.name_id[to], old.arrival_time, old.total_time, old.block_interval,
+                    old.weight, old.deadline);
+            processes.move(to, from);
+        }
+    }
+}
+
+template <class PolicyType, class ArrivalType>
+Scheduler::RunStats Scheduler::Simulate(ArrivalType& arrivals, const Options& options,
+        OutputWriter* out, CheckpointReader* resume, SnapshotLog* log) const {
+    RunStats stats = RunStats();
+    long long time = 0; //current simulation time
+    const ProcessTable& processes = arrivals.table(); //grows as processes arrive in online mode
+    int numCpus = options.cpus;
+    int numLive = 0; //arrived and not yet terminated
+    ProcessState state(processes);
+    int numSlots = state.size(); //process indices the per-process vectors have room for
+    WakeupHeap wakeups; //blocked processes
+    vector<Core> cores(numCpus);
+    PolicyType policy(options, state);
+    vector<int> preempted; //CPUs whose process's time slice just ended
+    bool modelCache = options.cache_penalty > 0;
+    long long admittedDensity = 0; //sum of total_time / deadline of admitted deadlines, in 1/2^20
+    vector<long long> leftCpu(modelCache ? numSlots : 0, 0); //time each process last stopped running
+    bool checkpointing = !options.checkpoint_file.empty();
+    long long nextCheckpoint = options.checkpoint_every; //time of the next periodic checkpoint
+    ShareMonitor shares(processes, numCpus, options.share_window,
+            options.summary_only ? nullptr : out, stats.share_error);
+    IoDevices devices(processes, options.io_devices, options.io_discipline, options.block_duration,
+            options.io_seek);
+    TraceWriter* timeline = (out != nullptr) ? trace.get() : nullptr;
+    long long longestBurst = 0; //longest burst dispatched, before any time slice cut
+    long long nextSnapshot = 0; //time of the next snapshot for log
+
+    if constexpr (ArrivalType::RESUMABLE) { //see Arrivals.h
+        if (resume != nullptr) { //read back what the checkpoint below wrote
+            time = resume->get<long long>();
+            stats = resume->get<RunStats>();
+            numLive = resume->get<int>();
+            numSlots = resume->get<int>();
+            admittedDensity = resume->get<long long>();
+            arrivals.load(*resume);
+            state.load(*resume);
+            wakeups.load(*resume);
+            resume->get(cores);
+            resume->get(leftCpu);
+            policy.resize(numSlots);
+            policy.load(*resume);
+            shares.load(*resume);
+            devices.load(*resume);
+            if (options.checkpoint_every > 0) {
+                nextCheckpoint = (time / options.checkpoint_every + 1) * options.checkpoint_every;
+            }
+        }
+    }
 
-                //new process became available
-                if (currentProcess->remaining_time == currentProcess->total_time && currentProcess->arrival_time < time) {
-                    ++activeProcesses;
+    if (out != nullptr) {
+        *out << PolicyType::NAME << " " << options.block_duration << " ";
+        policy.describe(*out);
+        if (numCpus > 1) {
+            *out << " cpus=" << numCpus << " migration_cost=" << options.migration_cost;
+        }
+        if (options.switch_cost > 0) {
+            *out << " switch_cost=" << options.switch_cost;
+        }
+        if (modelCache) {
+            *out << " cache_penalty=" << options.cache_penalty << " cache_decay=" << options.cache_decay;
+        }
+        if (options.admission_control) {
+            *out << " admission=on";
+        }
+        if (devices.enabled()) {
+            const char* disciplines[] = {"fifo", "sstf", "clook"};
+            *out << " io_devices=" << options.io_devices << " discipline=" << disciplines[options.io_discipline]
+                    << " seek=" << options.io_seek;
+        }
+        if (options.share_window > 0) {
+            *out << " share_window=" << options.share_window;
+        }
+        if (resume != nullptr) {
+            *out << " resumed=" << time;
+        }
+        *out << '\n';
+    }
+    if (timeline != nullptr) {
+        timeline->begin_run(PolicyType::NAME, numCpus);
+    }
+
+    while (true) {
+        //0) checkpoint or snapshot before anything happens at this time
+        if constexpr (ArrivalType::RESUMABLE) {
+            //the state of the run, as the resume code above reads it back
+            auto saveRun = [&](CheckpointWriter& checkpoint) {
+                checkpoint.put(time);
+                checkpoint.put(stats);
+                checkpoint.put(numLive);
+                checkpoint.put(numSlots);
+                checkpoint.put(admittedDensity);
+                arrivals.save(checkpoint);
+                state.save(checkpoint);
+                wakeups.save(checkpoint);
+                checkpoint.put(cores);
+                checkpoint.put(leftCpu);
+                policy.save(checkpoint);
+                shares.save(checkpoint);
+                devices.save(checkpoint);
+            };
+            if (checkpointing && (checkpointSignal != 0 ||
+                    (options.checkpoint_every > 0 && time >= nextCheckpoint))) {
+                int signal = checkpointSignal;
+                checkpointSignal = 0;
+                if (out != nullptr) {
+                    out->flush();
+                }
+                if (timeline != nullptr) {
+                    timeline->flush();
                 }
-                switched = false;
+                CheckpointWriter checkpoint(options.checkpoint_file);
+                SaveOptions(checkpoint, options);
+                processes.save(checkpoint);
+                saveRun(checkpoint);
+                checkpoint.commit();
+                if (options.checkpoint_every > 0) {
+                    nextCheckpoint = (time / options.checkpoint_every + 1) * options.checkpoint_every;
+                }
+                if (signal == SIGINT || signal == SIGTERM) {
+                    cerr << "checkpoint at time " << time << " written to " << options.checkpoint_file << "\n";
+                    exit(128 + signal);
+                }
+            }
+            if (log != nullptr && time >= nextSnapshot && !arrivals.empty() && longestBurst <= log->limit) {
+                CheckpointWriter snapshot;
+                saveRun(snapshot);
+                if (log->latest && !log->snapshots.empty() && log->snapshots.back().longest_burst == longestBurst) {
+                    log->snapshots.pop_back();
+                }
+                log->snapshots.push_back({time, longestBurst, snapshot.release()});
+                nextSnapshot = (time / log->every + 1) * log->every;
             }
         }
-        if (activeProcesses == 0) { //all processes have terminated
-            complete = true;
-            for (int i = 0; i < processes.size(); ++i) {//confirm no available processes
-                if (processes.at(i).termination_time == -1) {
-                    currentProcess = &processes.at(i);
-                    complete = false;
+
+        shares.advance(time);
+
+        //1) finish intervals ending now
+        for (int c = 0; c < numCpus; ++c) {
+            Core& core = cores[c];
+            if (core.running == -1 || core.end != time) {
+                continue;
+            }
+            int current = core.running;
+            int runTime = core.length;
+            if (modelCache) {
+                leftCpu[current] = time;
+            }
+            shares.stop(c, time);
+            if (PolicyType::PREEMPTIVE && out != nullptr && !options.summary_only) {
+                WriteInterval(*out, time - runTime, processes.name(current), runTime, core.status, c, numCpus);
+            }
+            if (PolicyType::PREEMPTIVE && timeline != nullptr) {
+                timeline->interval(c, time - runTime, runTime, processes.name(current), core.status);
+            }
+            if (core.status == 'T') { //process is terminated
+                state.remaining_time[current] = 0;
+                state.flags[current] |= ProcessState::TERMINATED;
+                //not running or blocked for I/O: waiting (a block happens each block_interval of CPU time)
+                long long turnaround = time - processes.arrival_time[current];
+                int total = processes.total_time[current];
+                int interval = processes.block_interval[current];
+                long long blocks = (interval > 0 && total > 0) ? (total - 1) / interval : 0;
+                stats.turnaround.record(turnaround);
+                long long away = devices.enabled() ? devices.away_time(current) : blocks * options.block_duration;
+                stats.waiting.record(turnaround - total - away);
+                int deadline = processes.deadline[current];
+                if (deadline > 0 && !(state.flags[current] & ProcessState::REJECTED)) {
+                    admittedDensity -= (static_cast<long long> (total) << 20) / deadline;
+                    long long lateness = turnaround - deadline;
+                    ++stats.deadlines;
+                    if (lateness > 0) {
+                        ++stats.missed;
+                    }
+                    stats.tardiness.record(lateness);
+                    if (out != nullptr && !options.summary_only) {
+                        *out << " <late>\t" << processes.name(current) << "\t" << lateness << '\n';
+                    }
                 }
+                shares.leave(current, true);
+                policy.on_exit(current, runTime);
+                --numLive;
+                arrivals.retire(current);
+                for (Core& other : cores) { //the index may be reused by a new process
+                    if (other.previous == current) {
+                        other.previous = -1;
+                    }
+                }
+            } else if (core.status == 'B') { //process is blocking
+                state.remaining_time[current] -= runTime;
+                state.time_until_blocked[current] = processes.block_interval[current];
+                state.flags[current] |= ProcessState::BLOCKED;
+                devices.block(time, current, wakeups);
+                shares.leave(current, false);
+                if (timeline != nullptr) {
+                    timeline->block(time, current, processes.name(current));
+                }
+                ++stats.blocks;
+                policy.on_block(current, runTime);
+            } else { //time slice occurs
+                state.remaining_time[current] -= runTime;
+                state.time_until_blocked[current] -= runTime;
+                preempted.push_back(c);
+                ++stats.slices;
+                policy.on_expire(current, runTime);
             }
-            if (complete) {
-                cout << " " << +time << "\t<done>\t" << AverageTurnaroundTime(processes) << std::endl;
+            if (core.status != 'S') {
+                core.running = -1;
+                core.idle_since = time;
             }
         }
-        if (wasIdle) {
-            wasIdle = false;
+        if (numLive == 0 && arrivals.empty()) { //blocked processes are live
+            break;
         }
-        ++currentIntervalTime;
-        ++time;
-    }
-}
+        policy.on_tick(time);
 
-void Scheduler::getNextIndex(int& currentIndex, int& numProcesses) {
-    if (currentIndex + 1 == numProcesses) {
-        currentIndex = 0;
-    } else {
-        ++currentIndex;
-    }
-}
+        //2) queue arrivals and unblocks
+        int admitted;
+        while ((admitted = NextAdmission(arrivals, state, time, wakeups)) != -1) {
+            int target = state.last_cpu[admitted];
+            if (target == -1) { //new arrival: least loaded CPU
+                ++numLive;
+                if (admitted >= numSlots) {
+                    numSlots = std::max(admitted + 1, 2 * numSlots);
+                    policy.resize(numSlots);
+                    shares.resize(numSlots);
+                    devices.resize(numSlots);
+                    if (modelCache) {
+                        leftCpu.resize(numSlots, 0);
+                    }
+                }
+                policy.on_arrive(admitted);
+                devices.on_arrive(admitted);
+                int deadline = processes.deadline[admitted];
+                if (deadline > 0) {
+                    //utilization test: the CPU time still promised by deadline must fit the CPUs
+                    long long density = (static_cast<long long> (processes.total_time[admitted]) << 20) / deadline;
+                    if (options.admission_control &&
+                            (density > (1LL << 20) || admittedDensity + density > (static_cast<long long> (numCpus) << 20))) {
+                        state.flags[admitted] |= ProcessState::REJECTED;
+                        ++stats.rejected;
+                    } else {
+                        admittedDensity += density;
+                    }
+                }
+                target = 0;
+                int targetLoad = -1;
+                for (int c = 0; c < numCpus; ++c) {
+                    int load = policy.size(c) + (cores[c].running != -1 ? 1 : 0);
+                    if (targetLoad == -1 || load < targetLoad) {
+                        target = c;
+                        targetLoad = load;
+                    }
+                }
+            } else { //unblocked: its I/O request completed and the device moves on
+                devices.unblock(time, admitted, wakeups);
+                if (timeline != nullptr) {
+                    timeline->unblock(time, admitted, processes.name(admitted));
+                }
+            }
+            shares.join(admitted);
+            policy.enqueue(target, admitted);
+        }
 
-/****
- * TODO:
- * - Implement shortest process next scheduling algorithm
- *****/
-void Scheduler::ShortestProcessNext(std::vector<Scheduler::Process> processes) {
-    //Documentation for std::priority_queue:
-    //http://en.cppreference.com/w/cpp/container/priority_queue
-    std::priority_queue<Process> blocked_list; //maintains the blocked process list
-    std::priority_queue<Process> ready_list; //maintains the ready list for SPN;
-    cout << "SPN " << BLOCK_DURATION << " " << TIME_SLICE << "\n";
-    int time = 0;
-    int runDuration = 0;
-    int timeLeftInSlice = TIME_SLICE;
-    int processesRemaining = processes.size();
-    bool done = false;
-        
-    /* Outer loop verifying that we have finished every process */
-    while (processesRemaining > 0) {
-        //while (timeLeftInSlice > 0) {
-        /* Add all processes that have arrived which are not completed or blocked */
-        for (Process p : processes) {
-            if (p.arrival_time <= time && p.remaining_time > 0 && !p.is_blocked) {
-                ready_list.push(p);
+        //2b) a preemptive policy may stop running processes in favour of those just queued
+        if constexpr (PolicyType::PREEMPTIVE) {
+            for (int c = 0; c < numCpus; ++c) {
+                Core& core = cores[c];
+                int current = core.running;
+                long long start = core.end - core.length;
+                if (current == -1 || core.end == time || start >= time ||
+                        !policy.preempts(c, current, time - start)) {
+                    continue; //idle, expiring now, still switching in, or keeps the CPU
+                }
+                int runTime = time - start;
+                core.busy -= core.length - runTime;
+                stats.busy_time -= core.length - runTime;
+                core.length = runTime;
+                core.end = time;
+                core.status = 'P';
+                state.remaining_time[current] -= runTime;
+                state.time_until_blocked[current] -= runTime;
+                if (modelCache) {
+                    leftCpu[current] = time;
+                }
+                shares.stop(c, time);
+                if (out != nullptr && !options.summary_only) {
+                    WriteInterval(*out, start, processes.name(current), runTime, 'P', c, numCpus);
+                }
+                if (timeline != nullptr) {
+                    timeline->interval(c, start, runTime, processes.name(current), 'P');
+                }
+                preempted.push_back(c);
+                ++stats.preemptions;
+                policy.on_preempt(current, runTime);
             }
         }
 
+        //3) processes arriving during the slice are queued ahead of the preempted process
+        for (int c : preempted) {
+            policy.enqueue(c, cores[c].running);
+            cores[c].running = -1;
+            cores[c].idle_since = time;
+        }
+        preempted.clear();
 
-        while (!ready_list.empty()) {
-            Process p = ready_list.top();
-            /* We may be able to complete process before time slice is over */
-            //if (p.remaining_time <= timeLeftInSlice) {
-
-            /* If we can complete the process before it gets blocked */
-            if (p.remaining_time <= p.time_until_blocked) {
-                int startTime = time;
-                cout << " " << startTime << "\t" << p.name << "\t" <<
-                        time << "\t" << "T" << endl;
-                /* Update time */
-                time += p.remaining_time;
-                timeLeftInSlice -= p.remaining_time;
-                /* Update process */
-                p.remaining_time = 0;
-                p.termination_time = time;
-                processesRemaining--;
-                ready_list.pop();
-                cout << " " << startTime << "\t" << p.name << "\t" <<
-                        time-startTime << "\t" << "T" << endl;
-                /* If there are more ready processes */
-                if(ready_list.size() == 0){
-                    for (Process p : processes) {
-                        if (p.arrival_time <= time && p.remaining_time > 0 && !p.is_blocked && p.termination_time > 0) {
-                            ready_list.push(p);
-                            ready_list.pop();
-                        }
-                        if(blocked_list.top().time_blocked + BLOCK_DURATION <= time){
-                            Process b = blocked_list.top();
-                            b.is_blocked = false;
-                            blocked_list.pop();
-                            ready_list.push(b);
-                            ready_list.pop();
+        //4) dispatch on every idle CPU: first from its own queue, then by stealing
+        for (int pass = 0; pass < 2; ++pass) {
+            for (int c = 0; c < numCpus; ++c) {
+                Core& core = cores[c];
+                if (core.running != -1) {
+                    continue;
+                }
+                int current = policy.pick_next(c);
+                if (current == -1 && pass == 0) {
+                    continue;
+                }
+                if (current == -1) { //steal from the CPU with the longest queue
+                    int source = -1;
+                    int longest = 0;
+                    for (int v = 0; v < numCpus; ++v) {
+                        if (policy.size(v) > longest) {
+                            source = v;
+                            longest = policy.size(v);
                         }
                     }
-                } 
-            }/* If we cannot complete our process before blocking */
-            else if (p.remaining_time > p.time_until_blocked) {
-                int startTime = time;
-                time += p.block_interval;
-                p.remaining_time -= p.time_until_blocked;
-                p.is_blocked = true;
-                p.time_blocked = time;
-                blocked_list.push(p);
-                ready_list.pop();
-                cout << " " << startTime << "\t" << p.name << "\t" <<
-                time-startTime << "\t" << "B" << endl;
-                
-                /* If there are more ready processes */
-                if(ready_list.size() == 0){
-                    for (Process p : processes) {
-                        if(p.arrival_time <= time && p.remaining_time > 0 && !p.is_blocked && p.termination_time > 0) {
-                            ready_list.push(p);
-                            ready_list.pop();
-                        }
-                        if(blocked_list.top().time_blocked + BLOCK_DURATION <= time){
-                            //cout << "TIME BLOCKED FOR " << blocked_list.top().name << ": " << blocked_list.top().time_blocked << endl;
-                            Process b = blocked_list.top();
-                            b.is_blocked = false;
-                            blocked_list.pop();
-                            ready_list.push(b);
-                            ready_list.pop();
+                    if (source == -1) {
+                        continue;
+                    }
+                    current = policy.steal(source, c);
+                }
+
+                long long start = time;
+                if (state.last_cpu[current] == -1) {
+                    stats.response.record(time - processes.arrival_time[current]);
+                }
+                if (state.last_cpu[current] != -1 && state.last_cpu[current] != c) {
+                    start += options.migration_cost;
+                    ++stats.migrations;
+                    stats.migration_time += options.migration_cost;
+                }
+                if (core.previous != current) {
+                    //another process ran here since: save and restore state, rewarm the cache
+                    start += options.switch_cost;
+                    stats.switch_time += options.switch_cost;
+                    if (modelCache && state.last_cpu[current] != -1) {
+                        long long penalty = options.cache_penalty;
+                        if (state.last_cpu[current] == c) {
+                            double warmth = exp(-(time - leftCpu[current]) / static_cast<double> (options.cache_decay));
+                            penalty = llround(options.cache_penalty * (1 - warmth));
                         }
+                        start += penalty;
+                        stats.cache_time += penalty;
+                    }
+                }
+                state.last_cpu[current] = c;
+
+                //run the process until it terminates, blocks or its time slice ends
+                long long runTime = state.NextBurst(current);
+                longestBurst = std::max(longestBurst, runTime);
+                char status = (runTime == state.remaining_time[current]) ? 'T' : 'B';
+                int quantum = policy.quantum(c, current);
+                if (quantum > 0 && quantum < runTime) {
+                    runTime = quantum;
+                    status = 'S';
+                }
+                if (out != nullptr && !options.summary_only) {
+                    if (core.idle_since < time) {
+                        WriteInterval(*out, core.idle_since, "<idle>", time - core.idle_since, 'I', c, numCpus);
+                    }
+                    if (!PolicyType::PREEMPTIVE) { //otherwise written when the interval ends
+                        WriteInterval(*out, start, processes.name(current), runTime, status, c, numCpus);
+                    }
+                }
+                if (timeline != nullptr) {
+                    if (core.idle_since < time) {
+                        timeline->interval(c, core.idle_since, time - core.idle_since, "<idle>", 'I');
+                    }
+                    if (!PolicyType::PREEMPTIVE) {
+                        timeline->interval(c, start, runTime, processes.name(current), status);
                     }
-                } 
+                }
+                if (core.previous != current) {
+                    ++stats.switches;
+                }
+                shares.start(c, current, start);
+                core.previous = current;
+                core.running = current;
+                core.status = status;
+                core.length = runTime;
+                core.end = start + runTime;
+                core.busy += runTime;
+                stats.busy_time += runTime;
+                ++stats.dispatches;
             }
         }
-        /* Update our blocked_list */
-        if (!ready_list.empty()) {
-            cout << " " << time << "\t" << "<idle>" << "\t" <<
-                    timeLeftInSlice << "\t" << "I" << endl;
+
+        //advance to the next event
+        long long nextEvent = NextEventTime(arrivals, wakeups);
+        for (int c = 0; c < numCpus; ++c) {
+            if (cores[c].running != -1 && (nextEvent == -1 || cores[c].end < nextEvent)) {
+                nextEvent = cores[c].end;
+            }
         }
+        time = nextEvent;
+    }
 
-        //time += (TIME_SLICE - timeLeftInSlice);
-        //timeLeftInSlice = TIME_SLICE;
+    stats.finish_time = time;
+    if (log != nullptr) {
+        log->longest_burst = longestBurst;
     }
-        //time+= TIME_SLICE;
-        //timeLeftInSlice = TIME_SLICE;
-        //cout << time << "\t" << p.name << "\t" << TIME_SLICE << endl;
-    //}
+    stats.average_turnaround = stats.turnaround.mean();
+    stats.max_turnaround = stats.turnaround.max();
+    if (out != nullptr) {
+        *out << " " << time << "\t<done>\t" << stats.average_turnaround << '\n';
+        if (numCpus > 1) {
+            for (int c = 0; c < numCpus; ++c) {
+                *out << " <cpu>\t" << c << "\t" << cores[c].busy << "\t"
+                        << (time > 0 ? cores[c].busy / static_cast<double> (time) : 1.0) << '\n';
+            }
+            *out << " <migrations>\t" << stats.migrations << "\t" << stats.migration_time << '\n';
+        }
+        if (devices.enabled()) {
+            devices.write(*out, time);
+        }
+        if ((options.switch_cost > 0 || modelCache) && !options.summary_only) {
+            WriteOverhead(*out, stats, numCpus);
+        }
+        if (stats.deadlines + stats.rejected > 0 && !options.summary_only) {
+            WriteDeadlines(*out, stats);
+        }
+        if (stats.share_error.count() > 0 && !options.summary_only) {
+            WriteShares(*out, stats);
+        }
+        if (options.summary_only) {
+            WriteStats(*out, stats, numCpus);
+        }
+    }
+    return stats;
 }
 
-/**
- * Computes average turn around time of processes 
- * Resets variables that have been changed by scheduling algorithms
- * 
- * @param processes
- * @return 
- */
-float Scheduler::AverageTurnaroundTime(std::vector<Scheduler::Process> processes) {
-    float sum = 0;
-    for (int i = 0; i < processes.size(); ++i) {
-        sum += (processes.at(i).termination_time - processes.at(i).arrival_time);
-        //reset process data
-        processes.at(i).remaining_time = processes.at(i).total_time;
-        processes.at(i).termination_time = -1;
-        processes.at(i).is_blocked = false;
-        processes.at(i).time_blocked = processes.at(i).block_interval;
-    }
-    return sum / static_cast<float> (processes.size());
+template <class ArrivalType>
+Scheduler::RunStats Scheduler::Run(ArrivalType& arrivals, Policy policy, const Options& options,
+        OutputWriter* out, CheckpointReader* resume, SnapshotLog* log) const {
+    switch (policy) {
+        case ROUND_ROBIN:
+            return Simulate<RoundRobinPolicy>(arrivals, options, out, resume, log);
+        case SHORTEST_PROCESS_NEXT:
+            return Simulate<ShortestProcessNextPolicy>(arrivals, options, out, resume, log);
+        case PREDICTIVE_SPN:
+            return Simulate<PredictiveShortestProcessNextPolicy>(arrivals, options, out, resume, log);
+        case SHORTEST_REMAINING_TIME:
+            return Simulate<ShortestRemainingTimePolicy>(arrivals, options, out, resume, log);
+        case EARLIEST_DEADLINE:
+            return Simulate<EarliestDeadlinePolicy>(arrivals, options, out, resume, log);
+        case STRIDE:
+            return Simulate<StridePolicy>(arrivals, options, out, resume, log);
+        case LOTTERY:
+            return Simulate<LotteryPolicy>(arrivals, options, out, resume, log);
+        case MULTILEVEL_FEEDBACK:
+            return Simulate<MultilevelFeedbackPolicy>(arrivals, options, out, resume, log);
+        default:
+            return Simulate<CompletelyFairPolicy>(arrivals, options, out, resume, log);
+    }
+}
+
+Scheduler::RunStats Scheduler::Simulate(const ProcessTable& processes, Policy policy,
+        const Options& options, OutputWriter* out) const {
+    TableArrivals arrivals(processes);
+    return Run(arrivals, policy, options, out);
+}
+
+template <class ArrivalType>
+int Scheduler::NextAdmission(ArrivalType& arrivals, ProcessState& state, long long time,
+        WakeupHeap& wakeups) const {
+    bool arrived = !arrivals.empty() && arrivals.time() <= time;
+    if (!wakeups.empty() && wakeups.top_time() <= time &&
+            (!arrived || wakeups.top_time() <= arrivals.time())) {
+        int index = wakeups.pop();
+        state.flags[index] &= ~ProcessState::BLOCKED;
+        return index;
+    }
+    if (arrived) {
+        return arrivals.admit(state);
+    }
+    return -1;
+}
+
+template <class ArrivalType>
+long long Scheduler::NextEventTime(const ArrivalType& arrivals, const WakeupHeap& wakeups) const {
+    long long nextEvent = -1;
+    if (!arrivals.empty()) {
+        nextEvent = arrivals.time();
+    }
+    if (!wakeups.empty() && (nextEvent == -1 || wakeups.top_time() < nextEvent)) {
+        nextEvent = wakeups.top_time();
+    }
+    return nextEvent;
+}
+
+void Scheduler::WriteStats(OutputWriter& out, const RunStats& stats, int numCpus) const {
+    const char* labels[] = {" <turnaround>\t", " <waiting>\t", " <response>\t"};
+    const LatencyHistogram * histograms[] = {&stats.turnaround, &stats.waiting, &stats.response};
+    for (int h = 0; h < 3; ++h) {
+        const LatencyHistogram& histogram = *histograms[h];
+        out << labels[h] << histogram.mean() << "\t" << histogram.percentile(50) << "\t"
+                << histogram.percentile(90) << "\t" << histogram.percentile(99) << "\t"
+                << histogram.max() << '\n';
+    }
+    out << " <counts>\t" << stats.dispatches << "\t" << stats.switches << "\t" << stats.slices
+            << "\t" << stats.blocks << "\t" << stats.preemptions << '\n';
+    WriteOverhead(out, stats, numCpus);
+    double capacity = static_cast<double> (stats.finish_time) * numCpus;
+    out << " <utilization>\t" << stats.busy_time << "\t" << (capacity > 0 ? stats.busy_time / capacity : 1.0)
+            << "\t" << (stats.finish_time > 0 ? stats.turnaround.count() / static_cast<double> (stats.finish_time) : 0.0)
+            << '\n';
+    if (stats.deadlines + stats.rejected > 0) {
+        WriteDeadlines(out, stats);
+    }
+    if (stats.share_error.count() > 0) {
+        WriteShares(out, stats);
+    }
+}
+
+void Scheduler::WriteDeadlines(OutputWriter& out, const RunStats& stats) const {
+    out << " <deadlines>\t" << stats.deadlines << "\t" << stats.missed << "\t"
+            << (stats.deadlines > 0 ? stats.missed / static_cast<double> (stats.deadlines) : 0.0) << "\t"
+            << stats.rejected << '\n';
+    const LatencyHistogram& tardiness = stats.tardiness;
+    out << " <lateness>\t" << tardiness.mean() << "\t" << tardiness.percentile(50) << "\t"
+            << tardiness.percentile(90) << "\t" << tardiness.percentile(99) << "\t" << tardiness.max() << '\n';
+}
+
+void Scheduler::WriteShares(OutputWriter& out, const RunStats& stats) const {
+    const LatencyHistogram& error = stats.share_error;
+    out << " <share_error>\t" << error.mean() << "\t" << error.percentile(50) << "\t"
+            << error.percentile(90) << "\t" << error.percentile(99) << "\t" << error.max() << '\n';
+}
+
+void Scheduler::WriteOverhead(OutputWriter& out, const RunStats& stats, int numCpus) const {
+    double capacity = static_cast<double> (stats.finish_time) * numCpus;
+    out << " <overhead>\t" << stats.switch_time << "\t" << stats.cache_time << "\t"
+            << (capacity > 0 ? (stats.switch_time + stats.cache_time) / capacity : 0.0) << '\n';
 }
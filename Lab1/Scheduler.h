@@ -1,6 +1,8 @@
 /*
- * Scheduler class to implement Round-Robin and Shortest Process Next
- * scheduling algorithms 
+ * Scheduler class to simulate the Round-Robin, Shortest Process Next,
+ * predictive SPN, Shortest Remaining Time Next, multi-level feedback queue,
+ * completely fair, stride, lottery and Earliest Deadline First scheduling
+ * algorithms (see Policies.h)
  */
 
 /*
@@ -9,25 +11,40 @@
  * -Input file contains 1 line per process
  * -Lines are sorted in increasing order of arrival time in the system
  * 
- * -Line format --> name arrival_time total_time block_interval
+ * -Line format --> name arrival_time total_time block_interval [weight [deadline]]
  *  name: a sequence of non-blank characters representing the name of the process
  *  arrival_time: the time at which the process arrives in the system
  *  total_time: the total amount of CPU time which will be used by the process
  *  block_interval: interval at which will block for I/O. When a process blocks,
  *                  it is unavailable to run for the time specified by block_duration
- *                  in the scheduler parameter file
+ *                  in the scheduler parameter file (with I/O devices, that is the
+ *                  service time, after any queueing and seek)
+ *  weight: optional CPU share used by CFS, and tickets for stride and
+ *          lottery scheduling (default 1024)
+ *  deadline: optional time after arrival_time by which the process should
+ *            terminate, used by EDF and the deadline statistics (default 0: none)
  * 
  * OUTPUT: --> all output should be written to standard output
  * For each scheduling algorithm:
- * - A single line with the name of the scheduling algorithm (RR or SPN),
- *   followed by the block_duration (for both algorithms) and time_slice (for RR)
- *   as specified on the command line. Values should be separated by spaces.
+ * - A single line with the name of the scheduling algorithm (RR, SPN, PSPN,
+ *   SRTN, MLFQ, CFS, STRIDE, LOTTERY or EDF), followed by the block_duration
+ *   and the parameters its policy's describe() writes:
+ *      RR, SPN, STRIDE: time_slice
+ *      LOTTERY: time_slice seed=seed
+ *      PSPN, SRTN: alpha=alpha guess=guess
+ *      MLFQ: the quantum of each level, separated by commas, and boost=period
+ *            if boosting is on
+ *      CFS: granularity latency=latency
+ *      EDF: preemptive
+ *   then name=value pairs for the options which are on (cpus=, switch_cost=,
+ *   share_window=, ...). Values should be separated by spaces.
  * - One line for each interval during which a process is running or the system is 
  *   idle. The line should consist of a single space, followed by the current simulation
  *   time (starting at 0), followed by the process name (or "<idle>" if no process is
  *   running), the length of the interval and a status code:
  *      -"B" for blocked
  *      -"S" for time slice ended
+ *      -"P" for preempted by a process predicted to be shorter (SRTN)
  *      -"T" if the process terminated
  *      -"I" for an idle interval
  *   The fields should be separated by the tab character, '\t'.
@@ -35,6 +52,21 @@
  *   simulation time at which the last job terminated, a tab character, the string
  *   "<done>", another tab character, and the average turnaround time of all
  *   processes (floating point value)
+ * - Each process with a deadline adds a line when it terminates:
+ *   " <late>", tab, name, tab, termination time - (arrival_time + deadline)
+ *   (negative if early).
+ *   After <done>, a run with deadlines prints
+ *    <deadlines> count missed miss_fraction rejected
+ *    <lateness> mean p50 p90 p99 max   (time past the deadline, 0 if met)
+ * - With I/O devices, after <done> one line per device and the queueing delay:
+ *    <device> device requests busy_time utilization then the queue length a
+ *             request found (mean p50 p90 p99 max)
+ *    <io_wait> mean p50 p90 p99 max   (time a request waited for its device)
+ * - With a share window, one line per process and window in which it was
+ *   ready or running, and one when it terminates:
+ *   " <share>", tab, name, tab, window end, tab, achieved share, tab, target
+ *   share. After <done> (and its deadline lines) follows
+ *    <share_error> mean p50 p90 p99 max   (|achieved - target| CPU time)
  * 
  * Turnaround Time: termination time - arrival time
  */
@@ -50,18 +82,104 @@
 #ifndef SCHEDULER_H
 #define SCHEDULER_H
 
+#include <memory>
 #include <queue>
 #include <vector>
 #include <string>
+#include <string_view>
 #include <fstream>
+#include <csignal>
+#include <climits>
+
+#include "Checkpoint.h"
+#include "IoDevices.h"
+#include "LatencyHistogram.h"
+#include "OutputWriter.h"
+#include "ProcessTable.h"
+#include "TraceWriter.h"
+#include "WakeupHeap.h"
 
 class Scheduler {
 public:
+    /**
+     * Scheduling policies implemented by Simulate
+     */
+    enum Policy {
+        ROUND_ROBIN, SHORTEST_PROCESS_NEXT, MULTILEVEL_FEEDBACK, COMPLETELY_FAIR, PREDICTIVE_SPN,
+        SHORTEST_REMAINING_TIME, EARLIEST_DEADLINE, STRIDE, LOTTERY
+    };
+
+    /**
+     * Simulation settings given on the command line
+     */
+    struct Options {
+        int block_duration = 0; //time a process is unavailable to run after it blocks (I/O service time with devices)
+        int time_slice = 1; //length of the RR time slice
+        int cpus = 1; //number of simulated CPUs
+        int migration_cost = 0; //time lost when a process runs on a different CPU than last time
+        int num_threads = 0; //threads for a sweep, 0 for one per hardware thread
+        std::vector<Policy> policies = {ROUND_ROBIN, SHORTEST_PROCESS_NEXT}; //algorithms to run, in order
+        std::vector<int> mlfq_quanta; //MLFQ quantum per level, highest priority first (empty: time_slice * 1, 2, 4)
+        int mlfq_boost = 0; //MLFQ priority boost period, 0 for none
+        int cfs_latency = 0; //CFS target latency, 0 for 8 * time_slice (time_slice is the minimum granularity)
+        double burst_alpha = 0.5; //PSPN/SRTN weight of the latest CPU burst in the prediction
+        int burst_guess = 10; //PSPN/SRTN prediction for a process before its first burst
+        bool admission_control = false; //refuse deadlines which fail the utilization test (see Simulate)
+        unsigned long long lottery_seed = 1; //seed of the lottery draws
+        long long share_window = 0; //window of the achieved versus target share report, 0 for none
+        int io_devices = 0; //I/O devices blocks queue for, 0 for unlimited parallel I/O
+        IoDevices::Discipline io_discipline = IoDevices::FIFO; //order each device serves its queue in
+        int io_seek = 0; //time to seek across a whole simulated disk
+        int switch_cost = 0; //time lost on every context switch
+        int cache_penalty = 0; //cache warm-up time for a process which left the CPU long ago, 0 for none
+        int cache_decay = 100; //time constant of cache warmth loss while a process is away
+        bool summary_only = false; //print only the header, <done> and statistics lines of each run
+        std::string checkpoint_file; //where checkpoints of the run in progress go, empty for none
+        long long checkpoint_every = 0; //simulated time between checkpoints, 0 for only on a signal
+        std::string trace_file; //where the timeline of the printed runs goes as trace events, empty for none
+    };
+
+    /**
+     * @param policy
+     * @return name printed in the header line ("RR", "SPN", "MLFQ", "CFS", "PSPN", "SRTN", "EDF",
+     *         "STRIDE", "LOTTERY")
+     */
+    static const char* PolicyName(Policy policy);
+
     /**
      * Constructor - initialize processing
+     * Reads the input file and runs both algorithms, writing their intervals
+     * to standard output
      */
     Scheduler(std::string file_name_, int block_duration, int time_slice);
 
+    /**
+     * Constructor - initialize processing with the given options
+     * A file name of "-" reads the processes from standard input instead, as
+     * the simulation reaches their arrival (see ExecuteOnline)
+     */
+    Scheduler(std::string file_name_, const Options& options);
+
+    /**
+     * Constructor - read the input file only, for use with Sweep()
+     */
+    Scheduler(std::string file_name_);
+
+    /**
+     * Constructor - resume the run saved in a checkpoint file, then run the
+     * policies which were still to come after it
+     * 
+     * Each time slice given forks one continuation of the saved run, printed
+     * one after the other; all of them start from the same checkpoint, so
+     * what-if runs share the simulated prefix. Intervals already under way
+     * at the checkpoint finish as they were dispatched. With one time slice
+     * (or none: the saved one) the continuation keeps writing checkpoints
+     * like the original run; forks do not write any.
+     * @param checkpoint_file
+     * @param time_slices
+     */
+    Scheduler(const std::string& checkpoint_file, const std::vector<int>& time_slices);
+
     /**
      * Destructor - clean up processing
      */
@@ -76,78 +194,233 @@ public:
     Scheduler operator=(const Scheduler &other) = delete;
     Scheduler operator=(Scheduler &&other) = delete;
 
+    /**
+     * Parameter sweep: runs every policy in options.policies for every
+     * (block_duration, cpus) combination, and for every time_slice too if the
+     * policy uses one (RR, MLFQ, CFS, STRIDE, LOTTERY), spread across a pool of threads which share
+     * the process table read-only. Where the time slice only caps bursts
+     * (see SliceIsQuantum), the lanes of one (policy, block_duration, cpus)
+     * share a single run: the largest slice runs first, keeping snapshots,
+     * and every other slice resumes from the last snapshot before it would
+     * have cut a burst, or takes its result if it never would. Prints one line of summary statistics per
+     * run instead of the interval lines, in parameter order:
+     *  ALG BLOCK SLICE CPUS DONE AVG_TURNAROUND MAX_TURNAROUND UTILIZATION SWITCHES MIGRATIONS
+     *  P99_TURNAROUND AVG_WAITING AVG_RESPONSE OVERHEAD MISSED
+     * (SLICE is "-" for policies without one; UTILIZATION is busy time /
+     * (DONE * CPUS); SWITCHES counts dispatches; OVERHEAD is switch and cache
+     * time / (DONE * CPUS); MISSED is the fraction of deadlines missed, "-"
+     * without deadlines)
+     * @param block_durations
+     * @param time_slices
+     * @param cpus
+     * @param options policies, migration cost, MLFQ settings and number of threads
+     */
+    void Sweep(const std::vector<int>& block_durations, const std::vector<int>& time_slices,
+            const std::vector<int>& cpus, const Options& options);
+
+    /**
+     * Runs every policy in options.policies once without output and prints
+     * its timing as a Benchmark line:
+     *  ALG PROCESSES EVENTS SECONDS EVENTS_PER_SEC PEAK_RSS_KB
+     * where events are arrivals, unblocks and finished intervals
+     * @param options
+     */
+    void TimeRuns(const Options& options);
 
+    /**
+     * Runs every policy in options.policies for real, as green threads on
+     * options.cpus worker threads (see GreenRuntime.h), then simulated, and
+     * prints one Benchmark line per policy:
+     *  MIX ALG WORKERS TASKS SWITCHES NS_PER_SWITCH PREEMPTIONS SECONDS TASKS_PER_SEC
+     *  AVG_TURNAROUND SIM_AVG_TURNAROUND
+     * where both turnarounds are in time units. I/O devices, admission
+     * control and checkpoints are simulation only.
+     * @param options
+     * @param unit_ns real nanoseconds of one time unit
+     * @param mix label of the workload printed first
+     */
+    void TimeGreenThreads(const Options& options, long long unit_ns, const char* mix);
+
+    /**
+     * Incremental what-if runs: runs every policy in options.policies once
+     * as a baseline, keeping about num_snapshots snapshots of its state
+     * spread over the arrivals, then reads changes from standard input, one
+     * per line, each applied to the baseline on its own:
+     *  slice N                                  another time slice
+     *  name arrival total block [weight [deadline]]  new values for the
+     *                                           process of that name
+     * A changed run resumes from the last snapshot before the first event
+     * the change can affect: the arrival of the process (the earlier of its
+     * old and new one), or for RR the first dispatch of a burst longer than
+     * the smaller time slice. Policies without a time slice are not affected
+     * by one; other time slice policies start again from time 0. Prints one
+     * line for each baseline and for each change and policy:
+     *  ALG CHANGE RESUMED AVG_TURNAROUND DELTA SECONDS
+     * where CHANGE is "<baseline>" or the input line, RESUMED the simulated
+     * time the run resumed from and DELTA the change in average turnaround
+     * from the baseline. Malformed changes are reported and skipped.
+     * @param options
+     * @param num_snapshots
+     */
+    void WhatIf(const Options& options, int num_snapshots);
 
 private:
 
     /**
-     * struct to hold all necessary information about a process
-     */
-    struct Process {
-        std::string name; //name of process
-        int arrival_time; //arrival time of process in system
-        int total_time; //total time needed for process to run
-        int block_interval; //interval of time process blocks for I/O
-        int remaining_time; //might be useful for SPN
-        int termination_time; //might be useful for computing average turnaround time
-        int time_blocked; //keeps track of how long the process has been blocked for OR how long until the next block
-        int time_until_blocked;
-        bool is_blocked; //holds the block status of the process
-        
-        /**
-         * Implements less than operator for the priority queue
-         * ****Sorts Process(es) based on remaining_time or block interval time, whichever is shortest****
-         * @param x
-         * @return 
-         */
-        bool operator<(const Process& x) const {
-            if(remaining_time < block_interval){
-                if(x.remaining_time < x.block_interval){
-                    //Sort both by remaining_time
-                    return remaining_time < x.remaining_time;
-                } else {
-                    //Sort this process by remaining time and x process by block interval
-                    return remaining_time < x.block_interval;
-                } 
-            } else {
-                if(x.remaining_time < x.block_interval){
-                    //Sort this process by block interval and x process by remaining time
-                    return block_interval < x.remaining_time;
-                } else {
-                    //Sort both processes by block_interval
-                    return block_interval < x.block_interval;
-                }
-            }
-        }
+     * Summary of one run of a scheduling algorithm
+     */
+    struct RunStats {
+        long long finish_time; //time at which the last process terminated
+        double average_turnaround; //mean of termination time - arrival time
+        long long max_turnaround; //largest termination time - arrival time
+        long long busy_time; //total time a process was running, over all CPUs
+        long long dispatches; //number of intervals a process was given a CPU
+        long long migrations; //number of dispatches on a different CPU than last time
+        long long migration_time; //time lost to migrations
+        long long switch_time; //time lost to context switches
+        long long cache_time; //time lost to cache warm-up
+        long long slices; //intervals ended by the time slice
+        long long blocks; //intervals ended by blocking for I/O
+        long long switches; //dispatches of a different process than last ran on the CPU
+        long long preemptions; //intervals cut short by a preemptive policy
+        long long deadlines; //terminated processes with an admitted deadline
+        long long missed; //of those, processes which terminated after their deadline
+        long long rejected; //processes whose deadline admission control refused
+        LatencyHistogram turnaround; //termination time - arrival time
+        LatencyHistogram waiting; //time spent ready but not running
+        LatencyHistogram response; //first dispatch - arrival time
+        LatencyHistogram tardiness; //time past the deadline at termination, 0 if met
+        LatencyHistogram share_error; //|achieved - target| CPU time per process and share window
+    };
+
+    /**
+     * State of a run saved by Simulate before anything happened at an event
+     * time, to resume what-if runs from
+     */
+    struct Snapshot {
+        long long time;
+        long long longest_burst; //longest burst dispatched before it, before any time slice cut
+        std::vector<char> state; //what a checkpoint holds after the options and process table
+    };
+
+    /**
+     * Snapshots of a baseline run, one every so much simulated time while
+     * processes are still to arrive
+     */
+    struct SnapshotLog {
+        long long every = 1;
+        long long limit = LLONG_MAX; //no more snapshots once a burst longer than this was dispatched
+        bool latest = false; //keep only the latest snapshot of each longest_burst (enough to fork time slices)
+        std::vector<Snapshot> snapshots;
+        long long longest_burst = 0; //longest burst of the whole run, set at its end
+    };
+
+    static const int SWEEP_SNAPSHOTS = 256; //snapshot times of a sweep run whose time slice lanes fork from it
+
+    /**
+     * State of one simulated CPU
+     */
+    struct Core {
+        int running = -1; //process on the CPU, -1 if idle
+        long long end = 0; //time the current interval ends
+        int length = 0; //length of the current interval
+        char status = 0; //how the current interval ends (T/B/S)
+        long long idle_since = 0; //time the CPU last became idle
+        long long busy = 0; //total time spent running processes
+        int previous = -1; //process which ran last, for counting context switches
     };
 
+    ProcessTable processes; //workload read from the input file
 
     int BLOCK_DURATION; //decimal integer time length a process is unavailable to run after it blocks
     int TIME_SLICE; //decimal integer length of time slice for RoundRobin algorithm 
+    Options options; //settings for Execute
+    std::unique_ptr<TraceWriter> trace; //timeline of the printed runs, null without options.trace_file
 
     /**
-     * Extracts information from input file (allocates data into Process structs)
+     * Extracts information from input file (adds one ProcessTable row per process)
      * -Name: sequence of non-blank characters for name of process
      * -Arrival Time: time at which the process arrives
      * -Total Time: total amount of CPU time the process needs
      * -Block Interval: interval at which a process blocks for I/O
      * Format:
-     *  name arrival_time total_time block_interval
+     *  name arrival_time total_time block_interval [weight]
      * 
      * -All numeric values are decimal integers
      * -1 line per process (formatted as shown above)
+     * 
+     * The file is memory-mapped and scanned in place; names are kept as views
+     * into the mapping. Fields may be separated by spaces or tabs and blank
+     * lines are ignored. Every malformed line is reported with its line
+     * number, then the program exits with status 2.
      * @param file_name_
+     * @param table receives one row per process
      */
-    std::vector<Process> ParseFile(std::string file_name_);
+    void ParseFile(std::string file_name_, ProcessTable& table);
+
     
     
     /**
-     * Function to call both scheduling algorithms
-     * Passes the vector of processes read from the ParseFile method to both
-     * algorithms 
+     * Function to call the scheduling algorithms (RR and SPN unless other
+     * policies were selected)
+     * Passes the table of processes read from the ParseFile method to each
+     * algorithm; each algorithm keeps its own ProcessState
      * @param processes
      */
-    void Execute(std::vector<Scheduler::Process> processes);
+    void Execute(const ProcessTable& processes);
+
+    /**
+     * Online mode: runs the first policy in options.policies on processes
+     * read lazily from standard input. A process is read when simulated time
+     * reaches its arrival and its row is reused once it terminates, so memory
+     * is bounded by the number of processes alive at once, not the length of
+     * the input. Malformed and out-of-order lines are reported and skipped;
+     * if there were any the program exits with status 2 after the run.
+     */
+    void ExecuteOnline();
+
+    /**
+     * Makes SIGUSR1 request a checkpoint at the next event time, and SIGINT
+     * and SIGTERM a checkpoint followed by exit with status 128 + signal
+     */
+    static void CatchCheckpointSignals();
+
+    /**
+     * @param policy
+     * @return true if the policy has a time slice (varied by a sweep)
+     */
+    static bool UsesTimeSlice(Policy policy);
+
+    /**
+     * @param policy
+     * @param options
+     * @return true if the time slice only caps bursts (RR, LOTTERY, and MLFQ
+     *         with the default quanta): runs which differ only in it make the
+     *         same decisions until a burst longer than the smaller slice is
+     *         dispatched
+     */
+    static bool SliceIsQuantum(Policy policy, const Options& options);
+
+    /**
+     * Signal handler: records the signal for the event loop
+     * @param signal
+     */
+    static void RequestCheckpoint(int signal);
+
+    static volatile sig_atomic_t checkpointSignal; //signal asking for a checkpoint, 0 for none
+
+    /**
+     * Writes the options of a run to a checkpoint
+     * @param out
+     * @param options
+     */
+    static void SaveOptions(CheckpointWriter& out, const Options& options);
+
+    /**
+     * @param in
+     * @return options written by SaveOptions
+     */
+    static Options LoadOptions(CheckpointReader& in);
 
     /*****
      * For both algorithms below, when a process re-enters the ready queue
@@ -163,8 +436,17 @@ private:
      *  circular list
      * (Smaller time slice = better response time but reduces CPU efficiency)
      * (Larger time slice decreases the total amount of process switch overhead)
+     * 
+     * Each CPU's ready queue is a FIFO ReadyQueue.
+     * @param processes
+     * @param options block_duration, time_slice, cpus and migration_cost
+     * @param out writer for the header and interval lines, or nullptr for none
+     * @return summary of the run
      */
-    void RoundRobin(std::vector<Process> processes);
+    RunStats RoundRobin(const ProcessTable& processes, const Options& options,
+            OutputWriter* out) const {
+        return Simulate(processes, ROUND_ROBIN, options, out);
+    }
 
     /**
      * Shortest Process Next scheduling algorithm implementation:
@@ -173,24 +455,371 @@ private:
      * -Instead of making predictions, use the block_interval (or the total time
      *  left, whichever is shortest) of the processes in the ready list to determine 
      *  which process to run next
+     * 
+     * Non-preemptive: the chosen process runs until it blocks or terminates.
+     * Each CPU's ready list is an IndexedHeap of process indices keyed by
+     * ProcessState::NextBurst(), ties broken by the order processes became ready.
+     * @param processes
+     * @param options block_duration, cpus and migration_cost
+     * @param out writer for the header and interval lines, or nullptr for none
+     * @return summary of the run
+     */
+    RunStats ShortestProcessNext(const ProcessTable& processes, const Options& options,
+            OutputWriter* out) const {
+        return Simulate(processes, SHORTEST_PROCESS_NEXT, options, out);
+    }
+
+    /**
+     * Predictive Shortest Process Next scheduling algorithm implementation:
+     * 
+     * -Like SPN, but without knowing the future: the next CPU burst of each
+     *  process is predicted from its past bursts by exponential averaging,
+     *  prediction = burst_alpha * last_burst + (1 - burst_alpha) * prediction,
+     *  starting from burst_guess
+     * -The ready process with the shortest prediction runs next, until it
+     *  blocks or terminates
+     * 
+     * Comparing its statistics with SPN's on the same trace shows how far a
+     * realistic scheduler lands from the oracle. Prints alpha= and guess= in
+     * place of the time slice in the header line.
+     * @param processes
+     * @param options block_duration, burst_alpha, burst_guess, cpus and migration_cost
+     * @param out writer for the header and interval lines, or nullptr for none
+     * @return summary of the run
      */
-    void ShortestProcessNext(std::vector<Process> processes);
+    RunStats PredictiveShortestProcessNext(const ProcessTable& processes, const Options& options,
+            OutputWriter* out) const {
+        return Simulate(processes, PREDICTIVE_SPN, options, out);
+    }
 
     /**
-     * Computes the average turnaround time for a given scheduling algorithm
-     * Turnaround time = termination time - arrival time
-     * @return 
+     * Shortest Remaining Time Next scheduling algorithm implementation:
+     * 
+     * -Predictive SPN which also preempts: whenever processes arrive or
+     *  unblock, a running process is stopped (status "P") if a process queued
+     *  on its CPU is predicted to need less than what is predicted to remain
+     *  of the running process's burst
+     * -A preempted process is queued keyed on its predicted remaining burst
+     * 
+     * A process still switching in (migration, switch or cache cost) is not
+     * preempted. Interval lines are written when each interval ends.
+     * @param processes
+     * @param options block_duration, burst_alpha, burst_guess, cpus and migration_cost
+     * @param out writer for the header and interval lines, or nullptr for none
+     * @return summary of the run
      */
-    float AverageTurnaroundTime(std::vector<Process> processes);
-    
+    RunStats ShortestRemainingTime(const ProcessTable& processes, const Options& options,
+            OutputWriter* out) const {
+        return Simulate(processes, SHORTEST_REMAINING_TIME, options, out);
+    }
+
+    /**
+     * Earliest Deadline First scheduling algorithm implementation:
+     * 
+     * -The ready process whose absolute deadline (arrival_time + deadline)
+     *  comes first runs next; the ready lists are IndexedHeaps, O(log N)
+     * -Preemptive: when processes arrive or unblock, a running process is
+     *  stopped (status "P") if a process queued on its CPU has an earlier
+     *  deadline
+     * -Processes without a deadline, or refused by admission control, run
+     *  after all others in the order they became ready
+     * 
+     * Interval lines are written when each interval ends.
+     * @param processes
+     * @param options block_duration, admission_control, cpus and migration_cost
+     * @param out writer for the header and interval lines, or nullptr for none
+     * @return summary of the run
+     */
+    RunStats EarliestDeadlineFirst(const ProcessTable& processes, const Options& options,
+            OutputWriter* out) const {
+        return Simulate(processes, EARLIEST_DEADLINE, options, out);
+    }
+
+    /**
+     * Stride scheduling algorithm implementation:
+     * 
+     * -Every process holds tickets (the weight column) and a pass value;
+     *  running for t time units advances its pass by t * STRIDE1 / tickets
+     * -The ready process with the smallest pass runs next, for time_slice;
+     *  each CPU's ready list is an IndexedHeap, O(log N)
+     * -A new process joins at the CPU's global pass (the pass of the process
+     *  dispatched last) plus one stride; a process waking from a block
+     *  rejoins with the lead or lag it had when it left
+     * 
+     * Deterministic: CPU time is split in proportion to tickets with an
+     * error bounded by one time slice per process.
+     * @param processes
+     * @param options block_duration, time_slice, cpus and migration_cost
+     * @param out writer for the header and interval lines, or nullptr for none
+     * @return summary of the run
+     */
+    RunStats StrideScheduling(const ProcessTable& processes, const Options& options,
+            OutputWriter* out) const {
+        return Simulate(processes, STRIDE, options, out);
+    }
+
+    /**
+     * Lottery scheduling algorithm implementation:
+     * 
+     * -Every process holds tickets (the weight column)
+     * -At each dispatch one ticket of the ready processes is drawn at
+     *  random and its holder runs for time_slice; each CPU keeps its
+     *  tickets in a TicketTree (Fenwick tree), so a draw is O(log N)
+     * 
+     * Shares are proportional to tickets in expectation, with an error
+     * which shrinks as the square root of the number of draws. The draws
+     * are seeded with lottery_seed, printed as seed= in the header line.
+     * @param processes
+     * @param options block_duration, time_slice, lottery_seed, cpus and migration_cost
+     * @param out writer for the header and interval lines, or nullptr for none
+     * @return summary of the run
+     */
+    RunStats LotteryScheduling(const ProcessTable& processes, const Options& options,
+            OutputWriter* out) const {
+        return Simulate(processes, LOTTERY, options, out);
+    }
+
+    /**
+     * Multi-level feedback queue scheduling algorithm implementation:
+     * 
+     * -Processes enter the highest priority level when they arrive
+     * -The CPU always goes to the first process of the highest non-empty level
+     * -A process which uses its level's whole quantum is moved down one level
+     *  (CPU-bound processes sink), while a process which blocks first keeps
+     *  its level (I/O-bound processes stay at high priority)
+     * -Every boost period all processes move back to the highest level so
+     *  long-running processes are not starved
+     * 
+     * Like RR and SPN the running process is not preempted by arrivals; the
+     * quantum is the only preemption. Prints the quanta in place of the time
+     * slice in the header line.
+     * @param processes
+     * @param options block_duration, mlfq_quanta, mlfq_boost, cpus and migration_cost
+     * @param out writer for the header and interval lines, or nullptr for none
+     * @return summary of the run
+     */
+    RunStats MultilevelFeedback(const ProcessTable& processes, const Options& options,
+            OutputWriter* out) const {
+        return Simulate(processes, MULTILEVEL_FEEDBACK, options, out);
+    }
+
+    /**
+     * Completely fair scheduling algorithm implementation:
+     * 
+     * -Every process accumulates vruntime, its run time scaled by
+     *  DEFAULT_WEIGHT / weight, so heavier processes age more slowly
+     * -The CPU always goes to the ready process with the smallest vruntime
+     * -A process runs for its share of the target latency,
+     *  latency * weight / (total ready weight), but at least the minimum
+     *  granularity (time_slice); once more than latency / granularity
+     *  processes are ready the period stretches to granularity per process
+     * -New processes start at the CPU's minimum vruntime; waking processes
+     *  are placed no further back than half a latency behind it, so sleepers
+     *  get a bounded head start
+     * 
+     * Picking the next process is O(log N). Prints the minimum granularity
+     * and the target latency in the header line.
+     * @param processes
+     * @param options block_duration, time_slice, cfs_latency, cpus and migration_cost
+     * @param out writer for the header and interval lines, or nullptr for none
+     * @return summary of the run
+     */
+    RunStats CompletelyFair(const ProcessTable& processes, const Options& options,
+            OutputWriter* out) const {
+        return Simulate(processes, COMPLETELY_FAIR, options, out);
+    }
+
+    /**
+     * Discrete-event simulation shared by all the algorithms:
+     * simulated time jumps directly to the next arrival, unblock, slice
+     * expiry or termination, so the cost depends on the number of scheduling
+     * events rather than the length of the run.
+     * 
+     * At each event time, in order:
+     * 1) intervals ending now finish (T/B/S), in CPU order
+     * 2) arrivals and unblocks up to now are queued in the order they
+     *    occurred (unblocks first when simultaneous). An arrival goes to the
+     *    least loaded CPU, an unblocked process back to the CPU it last ran on
+     *    (with a PREEMPTIVE policy, a running process the policy prefers one
+     *    of those to is stopped here as if its time slice ended)
+     * 3) processes whose time slice ended are queued on their own CPU, behind
+     *    anything which arrived while they ran
+     * 4) every idle CPU takes the next process from its own queue; CPUs still
+     *    idle then steal one from the CPU with the longest queue (see
+     *    steal() in Policies.h)
+     * A process dispatched on a different CPU than it last ran on first
+     * waits migration_cost time units on that CPU.
+     * 
+     * Dispatching a different process than the one which last ran on the CPU
+     * is a context switch and costs switch_cost time units before the
+     * interval starts. With cache_penalty set, a process returning after
+     * others ran also rewarms its cache first: cache_penalty * (1 -
+     * exp(-away / cache_decay)) time units, where away is the time since it
+     * last stopped running, or the whole cache_penalty on a different CPU.
+     * The header then names the costs, and an overhead line follows the
+     * <done> line:
+     *  <overhead> switch_time cache_time share_of_cpu_time
+     * 
+     * Every policy is measured against the deadlines in the input. With
+     * options.admission_control set (header: admission=on), an arriving
+     * process's deadline is refused when its density total_time / deadline
+     * exceeds 1, or would bring the sum over admitted, unfinished processes
+     * above the number of CPUs - the EDF utilization bound, checked against
+     * CPU demand only. A refused process still runs, best effort, and is
+     * counted as rejected instead of met or missed.
+     * 
+     * With options.io_devices set (header: io_devices=N discipline=D
+     * seek=S), a block is a request to one of that many devices instead of
+     * a fixed block_duration away: it waits for its device, then takes
+     * block_duration plus seek time (see IoDevices.h). The waiting
+     * statistics then leave out the whole time spent blocked.
+     * 
+     * With options.share_window set (header: share_window=N), every policy
+     * is measured against proportional sharing by weight: a ShareMonitor
+     * compares the CPU time each process got in each window with its share
+     * of the CPUs while it was ready or running (see ShareMonitor.h).
+     * 
+     * With more than one CPU each interval line ends with the CPU number, the
+     * header names the CPU count and migration cost, and per-CPU busy time
+     * and utilization and the migration totals follow the <done> line:
+     *  <cpu> cpu busy_time utilization
+     *  <migrations> count time
+     * 
+     * With options.summary_only set, the interval lines are skipped and the
+     * header and <done> line are followed by the statistics of the run
+     * (times as mean, 50th, 90th and 99th percentile and maximum):
+     *  <turnaround> mean p50 p90 p99 max
+     *  <waiting> mean p50 p90 p99 max
+     *  <response> mean p50 p90 p99 max
+     *  <counts> dispatches switches slices blocks preemptions
+     *  <overhead> switch_time cache_time share_of_cpu_time
+     *  <utilization> busy_time utilization throughput
+     * Statistics are gathered as processes terminate, in constant memory.
+     * 
+     * With options.checkpoint_file set, the whole state of the run is saved
+     * there before anything happens at an event time, every
+     * options.checkpoint_every time units and when a signal asks for it (see
+     * CatchCheckpointSignals); the output written so far is flushed first,
+     * so it ends where a resumed run carries on. A resumed run loads that
+     * state and prints its header line with resumed=time appended.
+     * 
+     * With options.trace_file set, a printed run (out not nullptr) also
+     * streams its intervals and I/O blocks to the Scheduler's TraceWriter,
+     * even with options.summary_only (see TraceWriter.h).
+     * 
+     * The ready queues and every scheduling decision belong to the policy
+     * type (see Policies.h), whose calls are resolved at compile time, and
+     * processes come from the arrival type (see Arrivals.h), which may add
+     * them to its table during the run and reuse the indices of terminated
+     * ones.
+     * @param arrivals source of the processes, in arrival order
+     * @param options
+     * @param out writer for the header and interval lines, or nullptr for none
+     * @param resume checkpoint positioned at the state of the run, or nullptr
+     *               to start from the beginning
+     * @param log receives snapshots of the run (see WhatIf), or nullptr
+     * @return summary of the run
+     */
+    template <class PolicyType, class ArrivalType>
+    RunStats Simulate(ArrivalType& arrivals, const Options& options, OutputWriter* out,
+            CheckpointReader* resume, SnapshotLog* log) const;
+
+    /**
+     * Runs Simulate with the policy type named by policy
+     * @param arrivals source of the processes, in arrival order
+     * @param policy
+     * @param options
+     * @param out writer for the header and interval lines, or nullptr for none
+     * @param resume checkpoint positioned at the state of the run, or nullptr
+     * @param log receives snapshots of the run, or nullptr
+     * @return summary of the run
+     */
+    template <class ArrivalType>
+    RunStats Run(ArrivalType& arrivals, Policy policy, const Options& options, OutputWriter* out,
+            CheckpointReader* resume = nullptr, SnapshotLog* log = nullptr) const;
+
     /**
-     * Sets the currentIndex to the next valid index of the process list
-     * (wraps the list)
-     * @param currentIndex
-     * @param numProcesses
+     * Runs Simulate on a table read in full
+     * @param processes
+     * @param policy
+     * @param options
+     * @param out writer for the header and interval lines, or nullptr for none
+     * @return summary of the run
      */
-    void getNextIndex(int& currentIndex, int& numProcesses);
+    RunStats Simulate(const ProcessTable& processes, Policy policy, const Options& options,
+            OutputWriter* out) const;
+
+    /**
+     * Writes one interval line (see the top of this file)
+     * @param out
+     * @param start
+     * @param name process name or "<idle>"
+     * @param length
+     * @param status
+     * @param cpu
+     * @param numCpus the CPU is written only if there is more than one
+     */
+    void WriteInterval(OutputWriter& out, long long start, std::string_view name, long long length,
+            char status, int cpu, int numCpus) const {
+        out << ' ' << start << '\t' << name << '\t' << length << '\t' << status;
+        if (numCpus > 1) {
+            out << '\t' << cpu;
+        }
+        out << '\n';
+    }
+
+    /**
+     * Writes the <deadlines> and <lateness> lines of a run (see the top of
+     * this file)
+     * @param out
+     * @param stats
+     */
+    void WriteDeadlines(OutputWriter& out, const RunStats& stats) const;
+
+    /**
+     * Writes the <share_error> line of a run (see the top of this file)
+     * @param out
+     * @param stats
+     */
+    void WriteShares(OutputWriter& out, const RunStats& stats) const;
+
+    /**
+     * Writes the statistics lines of a run (see Simulate)
+     * @param out
+     * @param stats
+     * @param numCpus
+     */
+    void WriteStats(OutputWriter& out, const RunStats& stats, int numCpus) const;
+
+    /**
+     * Writes the <overhead> line of a run (see Simulate)
+     * @param out
+     * @param stats
+     * @param numCpus
+     */
+    void WriteOverhead(OutputWriter& out, const RunStats& stats, int numCpus) const;
+
+    /**
+     * Returns the next process which has arrived or finished blocking by the
+     * given time, in the order the events occurred, or -1 if there is none.
+     * The returned process is no longer blocked and should be made ready.
+     * @param arrivals processes yet to arrive (updated)
+     * @param state BLOCKED flag is cleared on unblock
+     * @param time current simulation time
+     * @param wakeups blocked processes (updated)
+     * @return process index or -1
+     */
+    template <class ArrivalType>
+    int NextAdmission(ArrivalType& arrivals, ProcessState& state, long long time, WakeupHeap& wakeups) const;
+
+    /**
+     * Returns the time of the next arrival or unblock event, or -1 if
+     * no such event is pending
+     * @param arrivals processes yet to arrive
+     * @param wakeups blocked processes
+     */
+    template <class ArrivalType>
+    long long NextEventTime(const ArrivalType& arrivals, const WakeupHeap& wakeups) const;
 };
 
 #endif /* SCHEDULER_H */
-
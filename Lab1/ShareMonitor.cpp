@@ -0,0 +1,120 @@
+/*
+ * File:   ShareMonitor.cpp
+ */
+
+#include "ShareMonitor.h"
+
+#include <cmath>
+
+ShareMonitor::ShareMonitor(const ProcessTable& table_, int cpus_, long long window_, OutputWriter* out_,
+        LatencyHistogram& error_)
+: table(table_), cpus(cpus_), window(window_), out(out_), error(error_), windowEnd(window_), lastTime(0),
+perTicket(0), competing(0), competingTickets(0), runner(window_ > 0 ? cpus_ : 0, -1),
+runFrom(window_ > 0 ? cpus_ : 0, 0) {
+    resize(table_.size());
+}
+
+void ShareMonitor::resize(int count) {
+    if (window > 0 && count > static_cast<int> (flags.size())) {
+        flags.resize(count, 0);
+        slot.resize(count, 0);
+        joined.resize(count, 0);
+        target.resize(count, 0);
+        run.resize(count, 0);
+    }
+}
+
+void ShareMonitor::join(int index) {
+    if (window > 0) {
+        flags[index] |= COMPETING;
+        joined[index] = perTicket;
+        ++competing;
+        competingTickets += table.weight[index];
+        List(index);
+    }
+}
+
+void ShareMonitor::leave(int index, bool terminated) {
+    if (window > 0) {
+        Settle(index);
+        flags[index] &= ~COMPETING;
+        --competing;
+        competingTickets -= table.weight[index];
+        if (terminated) {
+            //a new process reusing the index joins the window afresh
+            Emit(index);
+            members[slot[index]] = -1;
+            flags[index] &= ~LISTED;
+        }
+    }
+}
+
+void ShareMonitor::Emit(int index) {
+    if (target[index] == 0 && run[index] == 0) {
+        return;
+    }
+    error.record(llround(fabs(run[index] - target[index])));
+    if (out != nullptr) {
+        double capacity = static_cast<double> (window) * cpus;
+        *out << " <share>\t" << table.name(index) << '\t' << windowEnd << '\t' << run[index] / capacity
+                << '\t' << target[index] / capacity << '\n';
+    }
+    target[index] = 0;
+    run[index] = 0;
+}
+
+void ShareMonitor::Close() {
+    for (int c = 0; c < cpus; ++c) {
+        if (runner[c] != -1) {
+            Credit(c, windowEnd);
+        }
+    }
+    //processes still competing stay members of the next window
+    int kept = 0;
+    for (int index : members) {
+        if (index == -1) {
+            continue;
+        }
+        if (flags[index] & COMPETING) {
+            Settle(index);
+            slot[index] = kept;
+            members[kept++] = index;
+        } else {
+            flags[index] &= ~LISTED;
+        }
+        Emit(index);
+    }
+    members.resize(kept);
+}
+
+void ShareMonitor::save(CheckpointWriter& out) const {
+    out.put(windowEnd);
+    out.put(lastTime);
+    out.put(perTicket);
+    out.put(competing);
+    out.put(competingTickets);
+    out.put(members);
+    out.put(flags);
+    out.put(slot);
+    out.put(joined);
+    out.put(target);
+    out.put(run);
+    out.put(runner);
+    out.put(runFrom);
+}
+
+void ShareMonitor::load(CheckpointReader& in) {
+    windowEnd = in.get<long long>();
+    lastTime = in.get<long long>();
+    perTicket = in.get<double>();
+    competing = in.get<int>();
+    competingTickets = in.get<long long>();
+    in.get(members);
+    in.get(flags);
+    in.get(slot);
+    in.get(joined);
+    in.get(target);
+    in.get(run);
+    in.get(runner);
+    in.get(runFrom);
+}
@@ -0,0 +1,220 @@
+/*
+ * ShareMonitor - achieved versus target CPU share per process, per window
+ *
+ * Simulated time is cut into consecutive windows of a fixed length. Within
+ * a window, a process's target is its proportional share of the CPUs while
+ * it competes for them (ready or running, not blocked):
+ *  target = integral of tickets / competing_tickets * min(cpus, competing) dt
+ * and what it achieved is the CPU time it actually got. Tickets are the
+ * weight column of the input. At the end of each window, and when a process
+ * terminates, one row per process which competed is written:
+ *  <share> name window_end achieved target
+ * with both as fractions of the window's capacity (length * cpus), and
+ * |achieved - target| in time units goes into a histogram: the fairness
+ * error of the policy.
+ *
+ * The integral is kept as one running sum of min(cpus, competing) /
+ * competing_tickets over time, so joining, leaving and every event cost
+ * O(1); only closing a window walks the processes which competed in it.
+ */
+
+/*
+ * File:   ShareMonitor.h
+ */
+
+#ifndef SHAREMONITOR_H
+#define SHAREMONITOR_H
+
+#include <vector>
+
+#include "Checkpoint.h"
+#include "LatencyHistogram.h"
+#include "OutputWriter.h"
+#include "ProcessTable.h"
+
+class ShareMonitor {
+public:
+    /**
+     * Constructor - a window of 0 turns the monitor off, and every call
+     * below returns at once
+     * @param table_ processes (names and tickets)
+     * @param cpus_ number of CPUs
+     * @param window_ window length
+     * @param out_ writer for the <share> rows, or nullptr for none
+     * @param error_ receives |achieved - target| of each row
+     */
+    ShareMonitor(const ProcessTable& table_, int cpus_, long long window_, OutputWriter* out_,
+            LatencyHistogram& error_);
+    ~ShareMonitor() {}
+
+    ShareMonitor(const ShareMonitor &other) = delete;
+    ShareMonitor(ShareMonitor &&other) = delete;
+    ShareMonitor operator=(const ShareMonitor &other) = delete;
+    ShareMonitor operator=(ShareMonitor &&other) = delete;
+
+    /**
+     * Makes room for indices 0 .. count-1 if there is less
+     * @param count
+     */
+    void resize(int count);
+
+    /**
+     * Moves the clock forward, closing every window which ended by then;
+     * called once per event time before anything changes
+     * @param time
+     */
+    void advance(long long time) {
+        if (window > 0) {
+            while (time >= windowEnd) {
+                Integrate(windowEnd);
+                Close();
+                windowEnd += window;
+                if (time >= windowEnd && Idle()) {
+                    //nothing competes, so the windows up to time have no rows
+                    windowEnd = (time / window + 1) * window;
+                }
+            }
+            Integrate(time);
+        }
+    }
+
+    /**
+     * A process became ready after arriving or unblocking
+     * @param index
+     */
+    void join(int index);
+
+    /**
+     * A process blocked, or terminated (its row is then written at once,
+     * since the index may be reused)
+     * @param index
+     * @param terminated
+     */
+    void leave(int index, bool terminated);
+
+    /**
+     * A process was dispatched; the CPU is its own from start
+     * @param cpu
+     * @param index
+     * @param start
+     */
+    void start(int cpu, int index, long long start) {
+        if (window > 0) {
+            runner[cpu] = index;
+            runFrom[cpu] = start;
+        }
+    }
+
+    /**
+     * The interval on a CPU ended (or was cut short) at time
+     * @param cpu
+     * @param time
+     */
+    void stop(int cpu, long long time) {
+        if (window > 0 && runner[cpu] != -1) {
+            Credit(cpu, time);
+            runner[cpu] = -1;
+        }
+    }
+
+    void save(CheckpointWriter& out) const;
+    void load(CheckpointReader& in);
+
+private:
+    static const char COMPETING = 1; //ready or running
+    static const char LISTED = 2; //in members
+
+    /**
+     * @return whether no process is a member of the current window and no
+     * CPU has a runner
+     */
+    bool Idle() const {
+        if (!members.empty()) {
+            return false;
+        }
+        for (int index : runner) {
+            if (index != -1) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Adds the time since the last call to the running sum
+     * @param time
+     */
+    void Integrate(long long time) {
+        if (competing > 0) {
+            perTicket += (time - lastTime) * static_cast<double> (competing < cpus ? competing : cpus) /
+                    competingTickets;
+        }
+        lastTime = time;
+    }
+
+    /**
+     * Gives the process on a CPU its run time up to time
+     * @param cpu
+     * @param time
+     */
+    void Credit(int cpu, long long time) {
+        if (time > runFrom[cpu]) {
+            run[runner[cpu]] += time - runFrom[cpu];
+            runFrom[cpu] = time;
+        }
+    }
+
+    /**
+     * Adds a process to the members of the current window
+     * @param index
+     */
+    void List(int index) {
+        if (!(flags[index] & LISTED)) {
+            flags[index] |= LISTED;
+            slot[index] = members.size();
+            members.push_back(index);
+        }
+    }
+
+    /**
+     * Brings a competing process's target up to now
+     * @param index
+     */
+    void Settle(int index) {
+        target[index] += (perTicket - joined[index]) * table.weight[index];
+        joined[index] = perTicket;
+    }
+
+    /**
+     * Writes a process's row for the current window, if it competed, and
+     * starts it afresh
+     * @param index
+     */
+    void Emit(int index);
+
+    /**
+     * Writes the rows of the window ending at windowEnd
+     */
+    void Close();
+
+    const ProcessTable& table;
+    int cpus;
+    long long window; //window length, 0 when off
+    OutputWriter* out;
+    LatencyHistogram& error;
+    long long windowEnd; //end of the current window
+    long long lastTime; //time perTicket is integrated up to
+    double perTicket; //integral of min(cpus, competing) / competingTickets
+    int competing; //number of competing processes
+    long long competingTickets; //their tickets
+    std::vector<int> members; //processes which competed in the current window, -1 for terminated ones
+    std::vector<char> flags; //per process, COMPETING | LISTED
+    std::vector<int> slot; //per process, position in members
+    std::vector<double> joined; //per process, perTicket when its target was last settled
+    std::vector<double> target; //per process, target CPU time in the current window
+    std::vector<long long> run; //per process, CPU time achieved in the current window
+    std::vector<int> runner; //per CPU, process in its current interval, -1 if none
+    std::vector<long long> runFrom; //per CPU, time up to which the runner was credited
+};
+
+#endif /* SHAREMONITOR_H */
@@ -0,0 +1,53 @@
+/*
+ * File:   StringPool.cpp
+ */
+
+#include "StringPool.h"
+
+#include <algorithm>
+
+StringPool::StringPool() : blockUsed(block_size), lookup(16, Hash{this}, Equal{this}) {
+}
+
+int StringPool::intern(std::string_view s) {
+    //add tentatively so the candidate can be hashed like any other entry
+    int id = size();
+    strings.push_back(s);
+    auto found = lookup.insert(id);
+    if (!found.second) { //already interned, roll back
+        strings.pop_back();
+        return *found.first;
+    }
+    if (blockUsed + s.size() > block_size) {
+        size_t size = s.size() > block_size ? s.size() : block_size;
+        blocks.emplace_back(new char[size]);
+        blockUsed = 0;
+    }
+    char* storage = blocks.back().get() + blockUsed;
+    std::copy(s.begin(), s.end(), storage);
+    blockUsed += s.size();
+    strings[id] = std::string_view(storage, s.size()); //same contents, so same hash
+    return id;
+}
+
+void StringPool::set(int id, std::string_view s) {
+    while (static_cast<int> (owned.size()) <= id) {
+        owned.emplace_back();
+        strings.emplace_back();
+    }
+    owned[id].assign(s.data(), s.size());
+    strings[id] = owned[id];
+}
+
+void StringPool::reserve(int count) {
+    strings.reserve(count);
+}
+
+size_t StringPool::bytes() const {
+    size_t ownedBytes = 0;
+    for (const std::string& s : owned) {
+        ownedBytes += sizeof (std::string) + s.capacity();
+    }
+    return blocks.size() * block_size + ownedBytes + strings.capacity() * sizeof (std::string_view) +
+            lookup.bucket_count() * sizeof (void*) + lookup.size() * (sizeof (int) + 2 * sizeof (void*));
+}
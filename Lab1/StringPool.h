@@ -0,0 +1,116 @@
+/*
+ * StringPool - interned storage for process names
+ * 
+ * Names are referred to by integer id. Names added with intern() are copied
+ * into the pool's own storage and equal names share one id. Names taken from
+ * a mapped input file are added with add_view(), which keeps a view into the
+ * file and skips the duplicate lookup (the characters already live in the
+ * mapping, so sharing ids would save nothing). The simulation only carries
+ * ids around, and the characters are touched only when output is written.
+ */
+
+/*
+ * File:   StringPool.h
+ */
+
+#ifndef STRINGPOOL_H
+#define STRINGPOOL_H
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+class StringPool {
+public:
+    StringPool();
+    ~StringPool() {}
+
+    /**
+     * Rule of 5:
+     * The lookup set refers back to this pool, so it cannot be copied or moved
+     */
+    StringPool(const StringPool &other) = delete;
+    StringPool(StringPool &&other) = delete;
+    StringPool operator=(const StringPool &other) = delete;
+    StringPool operator=(StringPool &&other) = delete;
+
+    /**
+     * Returns the id of the given string, copying it into the pool if needed
+     * @param s
+     * @return id
+     */
+    int intern(std::string_view s);
+
+    /**
+     * Adds a string without copying it or looking for an equal string; the
+     * characters must stay valid for the lifetime of the pool
+     * @param s
+     * @return id
+     */
+    int add_view(std::string_view s) {
+        strings.push_back(s);
+        return strings.size() - 1;
+    }
+
+    /**
+     * Stores a copy of a string under a caller-chosen id, replacing the
+     * string previously stored there; the copy's memory is reused, so a pool
+     * used this way stays as large as its largest id. Not to be mixed with
+     * intern() or add_view() in the same pool.
+     * @param id
+     * @param s
+     */
+    void set(int id, std::string_view s);
+
+    /**
+     * @param id
+     * @return characters of the string with the given id
+     */
+    std::string_view get(int id) const { return strings[id]; }
+
+    /**
+     * @return number of distinct strings
+     */
+    int size() const { return strings.size(); }
+
+    /**
+     * Reserves room for the given number of distinct strings
+     * @param count
+     */
+    void reserve(int count);
+
+    /**
+     * @return approximate number of bytes used by the pool
+     */
+    size_t bytes() const;
+
+private:
+    static const size_t block_size = 64 * 1024; //bytes per storage block
+
+    std::vector<std::string_view> strings; //characters of each string
+    std::vector<std::unique_ptr<char[]> > blocks; //storage for copied strings
+    std::deque<std::string> owned; //storage for set(), by id; a deque never moves its elements
+    size_t blockUsed; //bytes used in the last block
+
+
+    struct Hash {
+        const StringPool* pool;
+        size_t operator()(int id) const {
+            return std::hash<std::string_view>()(pool->get(id));
+        }
+    };
+
+    struct Equal {
+        const StringPool* pool;
+        bool operator()(int a, int b) const {
+            return pool->get(a) == pool->get(b);
+        }
+    };
+
+    std::unordered_set<int, Hash, Equal> lookup; //ids of all strings, hashed by content
+};
+
+#endif /* STRINGPOOL_H */
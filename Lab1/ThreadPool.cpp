@@ -0,0 +1,37 @@
+/*
+ * File:   ThreadPool.cpp
+ */
+
+#include "ThreadPool.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+ThreadPool::ThreadPool(int num_threads) : numThreads(num_threads) {
+    if (numThreads <= 0) {
+        numThreads = std::thread::hardware_concurrency();
+        if (numThreads <= 0) {
+            numThreads = 1;
+        }
+    }
+}
+
+void ThreadPool::run(int count, const std::function<void(int)> &job) {
+    std::atomic<int> nextJob(0);
+    auto worker = [&]() {
+        int j;
+        while ((j = nextJob.fetch_add(1)) < count) {
+            job(j);
+        }
+    };
+    int extra = (count < numThreads ? count : numThreads) - 1;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < extra; ++t) {
+        threads.emplace_back(worker);
+    }
+    worker(); //calling thread takes jobs too
+    for (std::thread& t : threads) {
+        t.join();
+    }
+}
@@ -0,0 +1,45 @@
+/*
+ * ThreadPool - run a batch of independent jobs on a fixed set of threads
+ * 
+ * Jobs are numbered 0 .. count-1 and handed out one at a time from a shared
+ * counter, so long and short jobs balance across the threads. run() returns
+ * once every job has finished.
+ */
+
+/*
+ * File:   ThreadPool.h
+ */
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <functional>
+
+class ThreadPool {
+public:
+    /**
+     * Constructor
+     * @param num_threads number of threads, or 0 to use one per hardware thread
+     */
+    ThreadPool(int num_threads);
+    ~ThreadPool() {}
+
+    ThreadPool(const ThreadPool &other) = delete;
+    ThreadPool(ThreadPool &&other) = delete;
+    ThreadPool operator=(const ThreadPool &other) = delete;
+    ThreadPool operator=(ThreadPool &&other) = delete;
+
+    /**
+     * Runs job(0) .. job(count-1) across the threads and waits for all of them
+     * @param count number of jobs
+     * @param job called with the job number
+     */
+    void run(int count, const std::function<void(int)> &job);
+
+    int size() const { return numThreads; }
+
+private:
+    int numThreads; //number of threads used by run()
+};
+
+#endif /* THREADPOOL_H */
@@ -0,0 +1,49 @@
+/*
+ * File:   TicketTree.cpp
+ */
+
+#include "TicketTree.h"
+
+TicketTree::TicketTree(int capacity) : tree(capacity + 1, 0), sum(0) {
+}
+
+int TicketTree::find(long long ticket) const {
+    //descend from the largest power of two, skipping every subtree which ends before the ticket
+    int size = tree.size();
+    int step = 1;
+    while (step * 2 < size) {
+        step *= 2;
+    }
+    int node = 0;
+    for (; step > 0; step /= 2) {
+        if (node + step < size && tree[node + step] <= ticket) {
+            node += step;
+            ticket -= tree[node];
+        }
+    }
+    return node; //node + 1 is the first node past the ticket, i.e. index node
+}
+
+void TicketTree::resize(int capacity) {
+    int oldSize = tree.size();
+    if (capacity + 1 <= oldSize) {
+        return;
+    }
+    //new indices hold no tickets, so a new node only sums the old nodes it covers
+    tree.resize(capacity + 1, 0);
+    for (int i = oldSize; i < static_cast<int> (tree.size()); ++i) {
+        for (int child = i - 1; child > i - (i & -i); child -= child & -child) {
+            tree[i] += tree[child];
+        }
+    }
+}
+
+void TicketTree::save(CheckpointWriter& out) const {
+    out.put(tree);
+    out.put(sum);
+}
+
+void TicketTree::load(CheckpointReader& in) {
+    in.get(tree);
+    sum = in.get<long long>();
+}
@@ -0,0 +1,69 @@
+/*
+ * TicketTree - Fenwick (binary indexed) tree of lottery tickets per process
+ *
+ * Holds a ticket count for each process index (0 for processes not in the
+ * lottery). Adding or removing a process's tickets and finding the holder
+ * of the n-th ticket both walk one path of the tree, O(log N), so a draw
+ * costs the same whether ten or a million processes are ready.
+ */
+
+/*
+ * File:   TicketTree.h
+ */
+
+#ifndef TICKETTREE_H
+#define TICKETTREE_H
+
+#include <vector>
+
+#include "Checkpoint.h"
+
+class TicketTree {
+public:
+    /**
+     * Constructor - room for indices 0 .. capacity-1, all without tickets
+     * @param capacity number of processes
+     */
+    TicketTree(int capacity);
+    ~TicketTree() {}
+
+    /**
+     * Adds tickets to (or, if negative, removes them from) a process
+     * @param index process index
+     * @param tickets
+     */
+    void add(int index, long long tickets) {
+        for (int i = index + 1; i < static_cast<int> (tree.size()); i += i & -i) {
+            tree[i] += tickets;
+        }
+        sum += tickets;
+    }
+
+    /**
+     * Returns the process holding a ticket, counting the tickets of index 0
+     * first, then index 1 and so on
+     * @param ticket 0 .. total()-1
+     * @return process index
+     */
+    int find(long long ticket) const;
+
+    /**
+     * @return tickets of all processes
+     */
+    long long total() const { return sum; }
+
+    /**
+     * Makes room for indices 0 .. capacity-1 if there is less
+     * @param capacity number of processes
+     */
+    void resize(int capacity);
+
+    void save(CheckpointWriter& out) const;
+    void load(CheckpointReader& in);
+
+private:
+    std::vector<long long> tree; //node i holds the tickets of indices i - (i & -i) .. i-1; tree[0] is unused
+    long long sum; //tickets of all processes
+};
+
+#endif /* TICKETTREE_H */
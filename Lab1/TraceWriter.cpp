@@ -0,0 +1,91 @@
+/*
+ * File:   TraceWriter.cpp
+ */
+
+#include "TraceWriter.h"
+
+#include <cstdlib>
+#include <iostream>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+TraceWriter::TraceWriter(const std::string& file_name) : fd(Open(file_name)), out(fd), run(0), first(true) {
+}
+
+TraceWriter::~TraceWriter() {
+    out << (first ? "[" : "") << "\n]\n";
+    out.flush();
+    close(fd);
+}
+
+int TraceWriter::Open(const std::string& file_name) {
+    int fd = open(file_name.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd == -1) {
+        std::cerr << "ERROR: could not create trace file: " << file_name << "\n";
+        exit(2);
+    }
+    return fd;
+}
+
+void TraceWriter::begin_run(std::string_view name, int cpus) {
+    ++run;
+    Next();
+    out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << run << ",\"args\":{\"name\":";
+    Quote(name);
+    out << "}}";
+    Next();
+    out << "{\"name\":\"process_sort_index\",\"ph\":\"M\",\"pid\":" << run << ",\"args\":{\"sort_index\":" << run
+            << "}}";
+    for (int c = 0; c < cpus; ++c) {
+        Next();
+        out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << run << ",\"tid\":" << c
+                << ",\"args\":{\"name\":\"CPU " << c << "\"}}";
+    }
+}
+
+void TraceWriter::interval(int cpu, long long start, long long length, std::string_view name, char status) {
+    Next();
+    out << "{\"name\":";
+    Quote(name);
+    out << ",\"cat\":\"" << status << "\",\"ph\":\"X\",\"ts\":" << start << ",\"dur\":" << length << ",\"pid\":"
+            << run << ",\"tid\":" << cpu << '}';
+}
+
+void TraceWriter::block(long long time, int index, std::string_view name) {
+    Async('b', time, index, name);
+}
+
+void TraceWriter::unblock(long long time, int index, std::string_view name) {
+    Async('e', time, index, name);
+}
+
+void TraceWriter::Async(char phase, long long time, int index, std::string_view name) {
+    //a process blocks again only after it unblocked, so its index pairs each b with its e
+    Next();
+    out << "{\"name\":";
+    Quote(name);
+    out << ",\"cat\":\"io\",\"ph\":\"" << phase << "\",\"ts\":" << time << ",\"pid\":" << run
+            << ",\"id2\":{\"local\":" << index << "}}";
+}
+
+void TraceWriter::Next() {
+    out << (first ? "[\n" : ",\n");
+    first = false;
+}
+
+void TraceWriter::Quote(std::string_view text) {
+    const char* hex = "0123456789abcdef";
+    out << '"';
+    for (char c : text) {
+        unsigned char u = static_cast<unsigned char> (c);
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if (u < 0x20) {
+            out << "\\u00" << hex[u >> 4] << hex[u & 15];
+        } else {
+            out << c;
+        }
+    }
+    out << '"';
+}
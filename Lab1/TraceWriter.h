@@ -0,0 +1,124 @@
+/*
+ * TraceWriter - streams the Scheduler's timeline as Chrome trace events
+ *
+ * The file is in the JSON array format of the Trace Event Format, which
+ * chrome://tracing and the Perfetto UI (ui.perfetto.dev) open directly.
+ * Every printed run becomes one trace process named after the policy, with
+ * one thread (track) per CPU:
+ *  - each interval is a complete event ("X") named after the process, or
+ *    "<idle>", with its status (T/B/S/P/I) as category
+ *  - each I/O block is an async event ("b" at the block, "e" at the unblock)
+ *    of category "io", which the viewers lay out on tracks of their own
+ * One simulated time unit is shown as one microsecond.
+ *
+ * Events go through an OutputWriter as they happen, so memory stays the
+ * same however long the timeline. The array is closed when the writer is
+ * destroyed; a trace cut short (e.g. by SIGINT) still opens, as the format
+ * allows the closing bracket to be missing.
+ */
+
+/*
+ * File:   TraceWriter.h
+ */
+
+#ifndef TRACEWRITER_H
+#define TRACEWRITER_H
+
+#include <string>
+#include <string_view>
+
+#include "OutputWriter.h"
+
+class TraceWriter {
+public:
+    /**
+     * Constructor - create (or truncate) the trace file
+     * Writes an error and exits with status 2 if it cannot be created
+     * @param file_name
+     */
+    TraceWriter(const std::string& file_name);
+
+    /**
+     * Destructor - close the event array and the file
+     */
+    ~TraceWriter();
+
+    TraceWriter(const TraceWriter &other) = delete;
+    TraceWriter(TraceWriter &&other) = delete;
+    TraceWriter operator=(const TraceWriter &other) = delete;
+    TraceWriter operator=(TraceWriter &&other) = delete;
+
+    /**
+     * Starts the trace process of a new run and names its CPU tracks
+     * @param name policy name
+     * @param cpus
+     */
+    void begin_run(std::string_view name, int cpus);
+
+    /**
+     * A process ran, or the CPU was idle, from start for length
+     * @param cpu
+     * @param start
+     * @param length
+     * @param name process name or "<idle>"
+     * @param status
+     */
+    void interval(int cpu, long long start, long long length, std::string_view name, char status);
+
+    /**
+     * A process blocked for I/O
+     * @param time
+     * @param index process index, which pairs the block with its unblock
+     * @param name
+     */
+    void block(long long time, int index, std::string_view name);
+
+    /**
+     * A process's I/O completed
+     * @param time
+     * @param index
+     * @param name
+     */
+    void unblock(long long time, int index, std::string_view name);
+
+    /**
+     * Writes out everything buffered so far
+     */
+    void flush() {
+        out.flush();
+    }
+
+private:
+    /**
+     * @param file_name
+     * @return descriptor of the new file
+     */
+    static int Open(const std::string& file_name);
+
+    /**
+     * Writes the separator before the next event
+     */
+    void Next();
+
+    /**
+     * Writes a JSON string, escaping quotes, backslashes and control characters
+     * @param text
+     */
+    void Quote(std::string_view text);
+
+    /**
+     * Writes one end of an I/O block
+     * @param phase 'b' or 'e'
+     * @param time
+     * @param index
+     * @param name
+     */
+    void Async(char phase, long long time, int index, std::string_view name);
+
+    int fd;
+    OutputWriter out;
+    int run; //trace process id of the current run, from 1
+    bool first; //no event written yet
+};
+
+#endif /* TRACEWRITER_H */
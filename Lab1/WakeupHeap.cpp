@@ -0,0 +1,66 @@
+/*
+ * File:   WakeupHeap.cpp
+ */
+
+#include "WakeupHeap.h"
+
+WakeupHeap::WakeupHeap() : pushCount(0) {
+}
+
+void WakeupHeap::push(long long time, int index) {
+    Entry entry = {time, pushCount++, index};
+    //sift the new entry up from the end of the heap
+    int pos = entries.size();
+    entries.push_back(entry);
+    while (pos > 0) {
+        int parent = (pos - 1) / arity;
+        if (!(entry < entries[parent])) {
+            break;
+        }
+        entries[pos] = entries[parent];
+        pos = parent;
+    }
+    entries[pos] = entry;
+}
+
+int WakeupHeap::pop() {
+    int index = entries[0].index;
+    Entry last = entries.back();
+    entries.pop_back();
+    int count = entries.size();
+    if (count == 0) {
+        return index;
+    }
+    //sift the last entry down from the root
+    int pos = 0;
+    while (true) {
+        int first = pos * arity + 1;
+        if (first >= count) {
+            break;
+        }
+        int smallest = first;
+        int end = (first + arity < count) ? first + arity : count;
+        for (int child = first + 1; child < end; ++child) {
+            if (entries[child] < entries[smallest]) {
+                smallest = child;
+            }
+        }
+        if (!(entries[smallest] < last)) {
+            break;
+        }
+        entries[pos] = entries[smallest];
+        pos = smallest;
+    }
+    entries[pos] = last;
+    return index;
+}
+
+void WakeupHeap::save(CheckpointWriter& out) const {
+    out.put(entries);
+    out.put(pushCount);
+}
+
+void WakeupHeap::load(CheckpointReader& in) {
+    in.get(entries); //already in heap order
+    pushCount = in.get<long long>();
+}
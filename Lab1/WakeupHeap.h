@@ -0,0 +1,68 @@
+/*
+ * WakeupHeap - blocked processes ordered by the time they become ready again
+ * 
+ * 4-ary min-heap keyed by absolute unblock time. Processes which unblock at
+ * the same time come out in the order they were blocked. Push and pop are
+ * O(log N), and the next unblock time is available in O(1), so the scheduler
+ * never has to walk the blocked processes.
+ */
+
+/*
+ * File:   WakeupHeap.h
+ */
+
+#ifndef WAKEUPHEAP_H
+#define WAKEUPHEAP_H
+
+#include <vector>
+
+#include "Checkpoint.h"
+
+class WakeupHeap {
+public:
+    WakeupHeap();
+    ~WakeupHeap() {}
+
+    /**
+     * Adds a blocked process
+     * @param time simulation time at which the process unblocks
+     * @param index process index
+     */
+    void push(long long time, int index);
+
+    /**
+     * Removes the process which unblocks first (heap must not be empty)
+     * @return process index
+     */
+    int pop();
+
+    /**
+     * @return unblock time of the first process to unblock (heap must not be empty)
+     */
+    long long top_time() const { return entries[0].time; }
+
+    bool empty() const { return entries.empty(); }
+    int size() const { return entries.size(); }
+    void clear() { entries.clear(); }
+
+    void save(CheckpointWriter& out) const;
+    void load(CheckpointReader& in);
+
+private:
+    static const int arity = 4; //children per node
+
+    struct Entry {
+        long long time; //unblock time
+        long long order; //insertion order, breaks ties between equal times
+        int index; //process index
+
+        bool operator<(const Entry& x) const {
+            return time < x.time || (time == x.time && order < x.order);
+        }
+    };
+
+    std::vector<Entry> entries; //heap storage
+    long long pushCount; //number of pushes so far
+};
+
+#endif /* WAKEUPHEAP_H */
@@ -0,0 +1,59 @@
+/*
+ * File:   WorkloadGenerator.cpp
+ */
+
+#include "WorkloadGenerator.h"
+#include "ProcessTable.h"
+
+#include <climits>
+#include <cmath>
+
+WorkloadGenerator::WorkloadGenerator(const Settings& settings_)
+: settings(settings_), random(settings_.seed) {
+}
+
+void WorkloadGenerator::Write(OutputWriter& out) {
+    double clock = 0; //arrival time of the latest process
+    long long burstLeft = 0; //processes still to arrive in the current burst
+    for (int i = 0; i < settings.count; ++i) {
+        if (!settings.bursty) {
+            clock += Exponential(settings.mean_gap);
+        } else {
+            //bursts arrive at the same average rate; their size is geometric
+            if (burstLeft == 0) {
+                clock += Exponential(settings.mean_gap * settings.burst);
+                burstLeft = 1;
+                if (settings.burst > 1) {
+                    burstLeft += static_cast<long long> (log(1 - Uniform()) / log(1 - 1 / settings.burst));
+                }
+            }
+            --burstLeft;
+        }
+        long long arrival = (clock < INT_MAX) ? static_cast<long long> (clock) : INT_MAX;
+
+        double total = ceil(settings.min_total / pow(1 - Uniform(), 1 / settings.alpha));
+        if (total > settings.max_total) {
+            total = settings.max_total;
+        }
+
+        int block = settings.cpu_interval;
+        if (Uniform() < settings.io_fraction) {
+            block = 1 + static_cast<int> (Uniform() * settings.io_interval);
+        }
+
+        out << 'P' << i << ' ' << arrival << ' ' << static_cast<int> (total) << ' ' << block;
+        if (settings.deadline_slack > 0) {
+            double deadline = ceil(settings.deadline_slack * total);
+            out << ' ' << ProcessTable::DEFAULT_WEIGHT << ' ' << static_cast<int> (deadline < INT_MAX ? deadline : INT_MAX);
+        }
+        out << '\n';
+    }
+}
+
+double WorkloadGenerator::Uniform() {
+    return (random() >> 11) * (1.0 / (1ULL << 53));
+}
+
+double WorkloadGenerator::Exponential(double mean) {
+    return -mean * log(1 - Uniform());
+}
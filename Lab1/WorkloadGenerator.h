@@ -0,0 +1,78 @@
+/*
+ * WorkloadGenerator - synthetic input files for the Scheduler
+ * 
+ * Writes lines in the input format (name arrival_time total_time
+ * block_interval) with Poisson or bursty arrivals, heavy-tailed (Pareto)
+ * total times and a mix of I/O-bound processes, which block after short
+ * intervals, and CPU-bound ones. The same settings and seed always produce
+ * the same file: random numbers come from std::mt19937_64 and are turned
+ * into distributions by hand rather than by the implementation-defined
+ * std:: distributions.
+ */
+
+/*
+ * File:   WorkloadGenerator.h
+ */
+
+#ifndef WORKLOADGENERATOR_H
+#define WORKLOADGENERATOR_H
+
+#include <random>
+
+#include "OutputWriter.h"
+
+class WorkloadGenerator {
+public:
+    /**
+     * Shape of the generated workload
+     */
+    struct Settings {
+        int count = 1000; //number of processes
+        unsigned long long seed = 1; //random seed
+        bool bursty = false; //arrivals in bursts instead of a Poisson stream
+        double mean_gap = 10; //mean time between arrivals
+        double burst = 8; //mean number of processes per burst (bursty only)
+        double alpha = 1.5; //Pareto shape of total_time, smaller is heavier tailed
+        int min_total = 10; //smallest total_time (Pareto scale)
+        int max_total = 100000; //total_time is cut off here
+        double io_fraction = 0.5; //share of I/O-bound processes
+        int io_interval = 5; //I/O-bound block_interval is 1 .. io_interval
+        int cpu_interval = 0; //block_interval of CPU-bound processes, 0 for never
+        double deadline_slack = 0; //deadline is deadline_slack * total_time, 0 for no deadlines
+    };
+
+    /**
+     * Constructor
+     * @param settings_
+     */
+    WorkloadGenerator(const Settings& settings_);
+    ~WorkloadGenerator() {}
+
+    WorkloadGenerator(const WorkloadGenerator &other) = delete;
+    WorkloadGenerator(WorkloadGenerator &&other) = delete;
+    WorkloadGenerator operator=(const WorkloadGenerator &other) = delete;
+    WorkloadGenerator operator=(WorkloadGenerator &&other) = delete;
+
+    /**
+     * Writes settings.count input lines, processes named P0, P1, ...
+     * @param out
+     */
+    void Write(OutputWriter& out);
+
+private:
+    /**
+     * @return uniformly distributed value in [0, 1)
+     */
+    double Uniform();
+
+    /**
+     * @param mean
+     * @return exponentially distributed value
+     */
+    double Exponential(double mean);
+
+    Settings settings;
+    std::mt19937_64 random; //seeded with settings.seed
+};
+
+#endif /* WORKLOADGENERATOR_H */
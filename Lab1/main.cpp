@@ -14,33 +14,525 @@
  *                Round-Robin scheduler
  * -Arguments are passed in the order shown above
  * 
+ * Optional arguments after the three above:
+ *  --cpus N            number of simulated CPUs (default 1)
+ *  --migration-cost N  time lost when a process moves to another CPU (default 0)
+ *  --threads N         number of threads for a sweep (default: one per core)
+ *  --policies LIST     algorithms to run, from rr,spn,mlfq,cfs,pspn,srtn,edf,
+ *                      stride,lottery (default rr,spn)
+ *  --mlfq-quanta LIST  MLFQ quantum per level, highest priority first
+ *                      (default time_slice,2*time_slice,4*time_slice)
+ *  --mlfq-boost N      MLFQ priority boost period (default 0: never)
+ *  --switch-cost N     time lost on every context switch (default 0)
+ *  --cache-penalty N   cache warm-up time of a process returning after others
+ *                      ran, scaled by how long it was away (default 0: none)
+ *  --cache-decay N     time constant of that scaling (default 100)
+ *  --output MODE       "full" (default) or "summary": skip the interval lines
+ *                      and print only the <done> and statistics lines
+ *  --cfs-latency N     CFS target latency (default 8*time_slice); time_slice
+ *                      is the CFS minimum granularity
+ *  --burst-alpha X     PSPN/SRTN weight of the latest burst in the predicted
+ *                      next burst, 0 < X <= 1 (default 0.5)
+ *  --burst-guess N     PSPN/SRTN prediction before a process's first burst
+ *                      (default 10)
+ *  --admission MODE    "on": refuse deadlines failing the EDF utilization
+ *                      test, "off" (default)
+ *  --io-devices N      queue blocks on N I/O devices serving one request at a
+ *                      time for block_duration plus seek (default 0: every
+ *                      block takes block_duration, however many are blocked)
+ *  --io-discipline D   order a device serves its queue in: "fifo" (default),
+ *                      "sstf" (closest track first) or "clook" (elevator)
+ *  --io-seek N         time to seek across a whole simulated disk (default 0)
+ *  --lottery-seed N    seed of the lottery draws (default 1)
+ *  --share-window N    report achieved versus target CPU share (by weight)
+ *                      of every process over windows of N time units
+ *  --checkpoint FILE   save the state of the run in progress to FILE on
+ *                      SIGUSR1, and on SIGINT/SIGTERM before exiting
+ *  --checkpoint-every N  also save it every N units of simulated time
+ *  --trace FILE        also write the timeline of every interval and I/O
+ *                      block to FILE as Chrome/Perfetto trace-event JSON
+ * 
+ * Sweep mode: if block_duration, time_slice or --cpus is given as a range
+ * first:last[:step], every combination is simulated in parallel and a
+ * summary table is printed instead of the interval lines.
+ * 
+ * Online mode: an input file name of "-" reads the processes from standard
+ * input as the simulation reaches their arrival, so the input may be longer
+ * than memory; only the first policy in --policies runs. Not with a sweep.
+ * 
+ * Lab1 generate count [generator options]
+ *  writes a synthetic input file to standard output:
+ *  --seed N            random seed (default 1)
+ *  --arrivals MODE     "poisson" (default) or "bursty"
+ *  --mean-gap X        mean time between arrivals (default 10)
+ *  --burst X           mean processes per burst (default 8)
+ *  --alpha X           Pareto shape of total_time (default 1.5)
+ *  --min-total N       smallest total_time (default 10)
+ *  --max-total N       largest total_time (default 100000)
+ *  --io-fraction X     share of I/O-bound processes (default 0.5)
+ *  --io-interval N     I/O-bound block_interval is 1..N (default 5)
+ *  --cpu-interval N    CPU-bound block_interval (default 0: never blocks)
+ *  --deadline-slack X  give every process a deadline of X * total_time
+ *                      (default 0: no deadlines)
+ * 
+ * Lab1 resume checkpoint_file [time_slice,...]
+ *  continues a checkpointed run, then the policies after it; several time
+ *  slices fork one continuation each from the same checkpoint
+ * 
+ * Lab1 whatif input_file block_duration time_slice [options] [--snapshots N]
+ *  runs each policy once as a baseline, keeping N snapshots of its state
+ *  (default 16), then reads changes from standard input ("slice N" or a
+ *  process line with new values for the process of that name) and prints
+ *  each change's average turnaround and delta from the baseline, resuming
+ *  from the last snapshot before the change can make a difference
+ * 
+ * Lab1 bench max_processes block_duration time_slice [options]
+ *  times each policy on generated workloads of 1k, 10k, ... max_processes
+ *  processes; takes the scheduler options above and the generator options
+ * 
+ * Lab1 runtime count block_duration time_slice [options] [--unit-ns N]
+ *  runs each policy for real, as green threads on --cpus worker threads, on
+ *  generated workloads of count processes (CPU-bound, mixed and I/O-bound),
+ *  and prints the cost of a switch and the real next to the simulated
+ *  average turnaround; a time unit is N nanoseconds of work (default 10000)
  */
 
-#include "Scheduler.h"
-
 #include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <sstream>
+#include <vector>
 
+#include <unistd.h>
+
+#include "Benchmark.h"
+#include "OutputWriter.h"
 #include "Scheduler.h"
+#include "WorkloadGenerator.h"
+
+/**
+ * Parses a value or a range first:last[:step] into the list of values
+ * @param arg
+ * @param values receives the values
+ * @return false if arg is not a valid value or range
+ */
+bool ParseRange(const char* arg, std::vector<int>& values) {
+    std::istringstream ss(arg);
+    int first, last, step = 1;
+    char sep;
+    if (!(ss >> first)) {
+        return false;
+    }
+    last = first;
+    if (ss >> sep) {
+        if (sep != ':' || !(ss >> last)) {
+            return false;
+        }
+        if (ss >> sep && (sep != ':' || !(ss >> step))) {
+            return false;
+        }
+    }
+    if (!ss.eof() || step <= 0 || last < first) {
+        return false;
+    }
+    for (int v = first; v <= last; v += step) {
+        values.push_back(v);
+    }
+    return true;
+}
+
+/**
+ * Parses a non-negative integer option value
+ * @param arg
+ * @param value receives the value
+ * @return false if arg is not a valid value
+ */
+bool ParseValue(const char* arg, int& value) {
+    std::istringstream ss(arg);
+    return (ss >> value) && ss.eof() && value >= 0;
+}
+
+/**
+ * Parses a non-negative floating point option value
+ * @param arg
+ * @param value receives the value
+ * @return false if arg is not a valid value
+ */
+bool ParseFraction(const char* arg, double& value) {
+    std::istringstream ss(arg);
+    return (ss >> value) && ss.eof() && value >= 0;
+}
+
+/**
+ * Parses a comma separated list of positive integers
+ * @param arg
+ * @param values receives the values
+ * @return false if arg is not a valid list
+ */
+bool ParseList(const char* arg, std::vector<int>& values) {
+    std::istringstream ss(arg);
+    std::string item;
+    values.clear();
+    while (std::getline(ss, item, ',')) {
+        int value;
+        if (!ParseValue(item.c_str(), value) || value == 0) {
+            return false;
+        }
+        values.push_back(value);
+    }
+    return !values.empty();
+}
+
+/**
+ * Parses a comma separated list of policy names (rr, spn, mlfq, cfs, pspn, srtn, edf,
+ * stride, lottery)
+ * @param arg
+ * @param policies receives the policies
+ * @return false if arg contains an unknown name
+ */
+bool ParsePolicies(const char* arg, std::vector<Scheduler::Policy>& policies) {
+    std::istringstream ss(arg);
+    std::string item;
+    policies.clear();
+    while (std::getline(ss, item, ',')) {
+        if (item == "rr") {
+            policies.push_back(Scheduler::ROUND_ROBIN);
+        } else if (item == "spn") {
+            policies.push_back(Scheduler::SHORTEST_PROCESS_NEXT);
+        } else if (item == "mlfq") {
+            policies.push_back(Scheduler::MULTILEVEL_FEEDBACK);
+        } else if (item == "cfs") {
+            policies.push_back(Scheduler::COMPLETELY_FAIR);
+        } else if (item == "pspn") {
+            policies.push_back(Scheduler::PREDICTIVE_SPN);
+        } else if (item == "srtn") {
+            policies.push_back(Scheduler::SHORTEST_REMAINING_TIME);
+        } else if (item == "edf") {
+            policies.push_back(Scheduler::EARLIEST_DEADLINE);
+        } else if (item == "stride") {
+            policies.push_back(Scheduler::STRIDE);
+        } else if (item == "lottery") {
+            policies.push_back(Scheduler::LOTTERY);
+        } else {
+            return false;
+        }
+    }
+    return !policies.empty();
+}
+
+/**
+ * Applies one scheduler option
+ * @param name option name, e.g. "--cpus"
+ * @param value
+ * @param options receives the setting
+ * @param cpus receives the --cpus values
+ * @return false if the option is unknown or its value is invalid
+ */
+bool ParseSchedulerOption(const char* name, const char* value, Scheduler::Options& options,
+        std::vector<int>& cpus) {
+    if (strcmp(name, "--cpus") == 0) {
+        cpus.clear();
+        return ParseRange(value, cpus) && cpus.front() > 0;
+    } else if (strcmp(name, "--migration-cost") == 0) {
+        return ParseValue(value, options.migration_cost);
+    } else if (strcmp(name, "--threads") == 0) {
+        return ParseValue(value, options.num_threads);
+    } else if (strcmp(name, "--switch-cost") == 0) {
+        return ParseValue(value, options.switch_cost);
+    } else if (strcmp(name, "--cache-penalty") == 0) {
+        return ParseValue(value, options.cache_penalty);
+    } else if (strcmp(name, "--cache-decay") == 0) {
+        return ParseValue(value, options.cache_decay) && options.cache_decay > 0;
+    } else if (strcmp(name, "--output") == 0) {
+        options.summary_only = strcmp(value, "summary") == 0;
+        return strcmp(value, "full") == 0 || options.summary_only;
+    } else if (strcmp(name, "--policies") == 0) {
+        return ParsePolicies(value, options.policies);
+    } else if (strcmp(name, "--mlfq-quanta") == 0) {
+        return ParseList(value, options.mlfq_quanta);
+    } else if (strcmp(name, "--mlfq-boost") == 0) {
+        return ParseValue(value, options.mlfq_boost);
+    } else if (strcmp(name, "--cfs-latency") == 0) {
+        return ParseValue(value, options.cfs_latency);
+    } else if (strcmp(name, "--burst-alpha") == 0) {
+        return ParseFraction(value, options.burst_alpha) && options.burst_alpha > 0 && options.burst_alpha <= 1;
+    } else if (strcmp(name, "--burst-guess") == 0) {
+        return ParseValue(value, options.burst_guess);
+    } else if (strcmp(name, "--admission") == 0) {
+        options.admission_control = strcmp(value, "on") == 0;
+        return strcmp(value, "off") == 0 || options.admission_control;
+    } else if (strcmp(name, "--io-devices") == 0) {
+        return ParseValue(value, options.io_devices);
+    } else if (strcmp(name, "--io-discipline") == 0) {
+        if (strcmp(value, "sstf") == 0) {
+            options.io_discipline = IoDevices::SSTF;
+        } else if (strcmp(value, "clook") == 0) {
+            options.io_discipline = IoDevices::CLOOK;
+        } else {
+            options.io_discipline = IoDevices::FIFO;
+            return strcmp(value, "fifo") == 0;
+        }
+        return true;
+    } else if (strcmp(name, "--io-seek") == 0) {
+        return ParseValue(value, options.io_seek);
+    } else if (strcmp(name, "--lottery-seed") == 0) {
+        std::istringstream ss(value);
+        return (ss >> options.lottery_seed) && ss.eof();
+    } else if (strcmp(name, "--share-window") == 0) {
+        std::istringstream ss(value);
+        return (ss >> options.share_window) && ss.eof() && options.share_window > 0;
+    } else if (strcmp(name, "--checkpoint") == 0) {
+        options.checkpoint_file = value;
+        return !options.checkpoint_file.empty();
+    } else if (strcmp(name, "--checkpoint-every") == 0) {
+        std::istringstream ss(value);
+        return (ss >> options.checkpoint_every) && ss.eof() && options.checkpoint_every > 0;
+    } else if (strcmp(name, "--trace") == 0) {
+        options.trace_file = value;
+        return !options.trace_file.empty();
+    }
+    return false;
+}
+
+/**
+ * Applies one workload generator option
+ * @param name option name, e.g. "--seed"
+ * @param value
+ * @param settings receives the setting
+ * @return false if the option is unknown or its value is invalid
+ */
+bool ParseGeneratorOption(const char* name, const char* value, WorkloadGenerator::Settings& settings) {
+    if (strcmp(name, "--seed") == 0) {
+        std::istringstream ss(value);
+        return (ss >> settings.seed) && ss.eof();
+    } else if (strcmp(name, "--arrivals") == 0) {
+        settings.bursty = strcmp(value, "bursty") == 0;
+        return strcmp(value, "poisson") == 0 || settings.bursty;
+    } else if (strcmp(name, "--mean-gap") == 0) {
+        return ParseFraction(value, settings.mean_gap);
+    } else if (strcmp(name, "--burst") == 0) {
+        return ParseFraction(value, settings.burst) && settings.burst >= 1;
+    } else if (strcmp(name, "--alpha") == 0) {
+        return ParseFraction(value, settings.alpha) && settings.alpha > 0;
+    } else if (strcmp(name, "--min-total") == 0) {
+        return ParseValue(value, settings.min_total) && settings.min_total > 0;
+    } else if (strcmp(name, "--max-total") == 0) {
+        return ParseValue(value, settings.max_total) && settings.max_total > 0;
+    } else if (strcmp(name, "--io-fraction") == 0) {
+        return ParseFraction(value, settings.io_fraction) && settings.io_fraction <= 1;
+    } else if (strcmp(name, "--io-interval") == 0) {
+        return ParseValue(value, settings.io_interval) && settings.io_interval > 0;
+    } else if (strcmp(name, "--cpu-interval") == 0) {
+        return ParseValue(value, settings.cpu_interval);
+    } else if (strcmp(name, "--deadline-slack") == 0) {
+        return ParseFraction(value, settings.deadline_slack);
+    }
+    return false;
+}
+
+/**
+ * Lab1 generate count [generator options]
+ */
+int Generate(int argc, char** argv) {
+    WorkloadGenerator::Settings settings;
+    if (argc < 3 || argc % 2 != 1 || !ParseValue(argv[2], settings.count)) {
+        std::cerr << "usage: Lab1 generate count [--seed N] [--arrivals poisson|bursty] [--mean-gap X] [--burst X]\n"
+                "       [--alpha X] [--min-total N] [--max-total N] [--io-fraction X] [--io-interval N] [--cpu-interval N]\n"
+                "       [--deadline-slack X]\n";
+        exit(1);
+    }
+    for (int i = 3; i < argc; i += 2) {
+        if (!ParseGeneratorOption(argv[i], argv[i + 1], settings)) {
+            std::cerr << "Invalid argument " << argv[i] << " " << argv[i + 1] << '\n';
+            exit(1);
+        }
+    }
+    WorkloadGenerator generator(settings);
+    OutputWriter out(STDOUT_FILENO);
+    generator.Write(out);
+    return 0;
+}
+
+/**
+ * Lab1 resume checkpoint_file [time_slice,...]
+ */
+int Resume(int argc, char** argv) {
+    std::vector<int> time_slices;
+    if (argc < 3 || argc > 4 || (argc == 4 && !ParseList(argv[3], time_slices))) {
+        std::cerr << "usage: Lab1 resume checkpoint_file [time_slice,...]\n";
+        exit(1);
+    }
+    Scheduler s(std::string(argv[2]), time_slices);
+    return 0;
+}
+
+/**
+ * Lab1 whatif input_file block_duration time_slice [scheduler options] [--snapshots N]
+ */
+int WhatIf(int argc, char** argv) {
+    Scheduler::Options options;
+    if (argc < 5 || argc % 2 != 1 || !ParseValue(argv[3], options.block_duration) ||
+            !ParseValue(argv[4], options.time_slice) || options.time_slice == 0) {
+        std::cerr << "usage: Lab1 whatif input_file block_duration time_slice [scheduler options] [--snapshots N]\n";
+        exit(1);
+    }
+    std::vector<int> cpus(1, 1);
+    int num_snapshots = 16;
+    for (int i = 5; i < argc; i += 2) {
+        if (strcmp(argv[i], "--snapshots") == 0) {
+            if (ParseValue(argv[i + 1], num_snapshots) && num_snapshots > 0) {
+                continue;
+            }
+        } else if (ParseSchedulerOption(argv[i], argv[i + 1], options, cpus) && cpus.size() == 1 &&
+                options.checkpoint_file.empty() && options.trace_file.empty()) {
+            continue;
+        }
+        std::cerr << "Invalid argument " << argv[i] << " " << argv[i + 1] << '\n';
+        exit(1);
+    }
+    options.cpus = cpus[0];
+    Scheduler s(argv[2]);
+    s.WhatIf(options, num_snapshots);
+    return 0;
+}
 
+/**
+ * Lab1 bench max_processes block_duration time_slice [scheduler and generator options]
+ */
+int Bench(int argc, char** argv) {
+    int max_processes;
+    Scheduler::Options options;
+    if (argc < 5 || argc % 2 != 1 || !ParseValue(argv[2], max_processes) ||
+            !ParseValue(argv[3], options.block_duration) || !ParseValue(argv[4], options.time_slice) ||
+            options.time_slice == 0) {
+        std::cerr << "usage: Lab1 bench max_processes block_duration time_slice [scheduler options] [generator options]\n";
+        exit(1);
+    }
+    WorkloadGenerator::Settings settings;
+    std::vector<int> cpus(1, 1);
+    for (int i = 5; i < argc; i += 2) {
+        if (!ParseSchedulerOption(argv[i], argv[i + 1], options, cpus) &&
+                !ParseGeneratorOption(argv[i], argv[i + 1], settings)) {
+            std::cerr << "Invalid argument " << argv[i] << " " << argv[i + 1] << '\n';
+            exit(1);
+        }
+    }
+    options.cpus = cpus[0];
+    Benchmark b(max_processes, settings, options);
+    return 0;
+}
+
+/**
+ * Lab1 runtime count block_duration time_slice [scheduler and generator options] [--unit-ns N]
+ */
+int Runtime(int argc, char** argv) {
+    int count;
+    Scheduler::Options options;
+    if (argc < 5 || argc % 2 != 1 || !ParseValue(argv[2], count) ||
+            !ParseValue(argv[3], options.block_duration) || !ParseValue(argv[4], options.time_slice) ||
+            options.time_slice == 0) {
+        std::cerr << "usage: Lab1 runtime count block_duration time_slice [scheduler options] [generator options]\n"
+                "       [--unit-ns N]\n";
+        exit(1);
+    }
+    WorkloadGenerator::Settings settings;
+    std::vector<int> cpus(1, 1);
+    long long unit_ns = 10000;
+    for (int i = 5; i < argc; i += 2) {
+        if (strcmp(argv[i], "--unit-ns") == 0) {
+            std::istringstream ss(argv[i + 1]);
+            if ((ss >> unit_ns) && ss.eof() && unit_ns > 0) {
+                continue;
+            }
+        } else if (ParseSchedulerOption(argv[i], argv[i + 1], options, cpus) ||
+                ParseGeneratorOption(argv[i], argv[i + 1], settings)) {
+            continue;
+        }
+        std::cerr << "Invalid argument " << argv[i] << " " << argv[i + 1] << '\n';
+        exit(1);
+    }
+    options.cpus = cpus[0];
+    Benchmark::GreenThreads(count, settings, options, unit_ns);
+    return 0;
+}
 
 int main(int argc, char** argv) {
-    if (argc != 4) {
-        std::cerr << "usage: Assignment1 input_file\n";
+    if (argc > 1 && strcmp(argv[1], "generate") == 0) {
+        return Generate(argc, argv);
+    }
+    if (argc > 1 && strcmp(argv[1], "bench") == 0) {
+        return Bench(argc, argv);
+    }
+    if (argc > 1 && strcmp(argv[1], "resume") == 0) {
+        return Resume(argc, argv);
+    }
+    if (argc > 1 && strcmp(argv[1], "runtime") == 0) {
+        return Runtime(argc, argv);
+    }
+    if (argc > 1 && strcmp(argv[1], "whatif") == 0) {
+        return WhatIf(argc, argv);
+    }
+    if (argc < 4 || argc % 2 != 0) {
+        std::cerr << "usage: Lab1 input_file block_duration time_slice [--cpus N] [--migration-cost N] [--threads N] [--output full|summary]\n"
+                "       [--switch-cost N] [--cache-penalty N] [--cache-decay N]\n"
+                "       [--policies rr,spn,mlfq,cfs,pspn,srtn,edf,stride,lottery] [--mlfq-quanta Q0,Q1,...] [--mlfq-boost N] [--cfs-latency N]\n"
+                "       [--burst-alpha X] [--burst-guess N] [--admission on|off]\n"
+                "       [--lottery-seed N] [--share-window N]\n"
+                "       [--io-devices N] [--io-discipline fifo|sstf|clook] [--io-seek N]\n"
+                "       [--checkpoint FILE] [--checkpoint-every N] [--trace FILE]\n"
+                "       Lab1 generate count [generator options]\n"
+                "       Lab1 resume checkpoint_file [time_slice,...]\n"
+                "       Lab1 whatif input_file block_duration time_slice [options] [--snapshots N]\n"
+                "       Lab1 bench max_processes block_duration time_slice [options]\n"
+                "       Lab1 runtime count block_duration time_slice [options] [--unit-ns N]\n";
         exit(1);
     }
-    std::istringstream ss1(argv[2]);
-    int block_duration;
-    if (!(ss1 >> block_duration))
+    std::vector<int> block_durations;
+    if (!ParseRange(argv[2], block_durations) || block_durations.front() < 0) {
         std::cerr << "Invalid argument1 " << argv[2] << '\n';
-    std::istringstream ss2(argv[3]);
-    int time_slice;
-    if (!(ss2 >> time_slice))
+        exit(1);
+    }
+    std::vector<int> time_slices;
+    if (!ParseRange(argv[3], time_slices) || time_slices.front() <= 0) {
         std::cerr << "Invalid argument " << argv[3] << '\n';
+        exit(1);
+    }
+    Scheduler::Options options;
+    std::vector<int> cpus(1, 1);
+    for (int i = 4; i < argc; i += 2) {
+        if (!ParseSchedulerOption(argv[i], argv[i + 1], options, cpus)) {
+            std::cerr << "Invalid argument " << argv[i] << " " << argv[i + 1] << '\n';
+            exit(1);
+        }
+    }
 
-    Scheduler s(argv[1], block_duration, time_slice); //create scheduler object and pass in command line arguments
+    bool sweep = block_durations.size() > 1 || time_slices.size() > 1 || cpus.size() > 1;
+    if (options.checkpoint_every > 0 && options.checkpoint_file.empty()) {
+        std::cerr << "Invalid argument --checkpoint-every (needs --checkpoint)\n";
+        exit(1);
+    }
+    if (!options.checkpoint_file.empty() && (sweep || strcmp(argv[1], "-") == 0)) {
+        std::cerr << "Invalid argument --checkpoint " << options.checkpoint_file
+                << " (not with a sweep or standard input)\n";
+        exit(1);
+    }
+    if (!options.trace_file.empty() && sweep) {
+        std::cerr << "Invalid argument --trace " << options.trace_file << " (not with a sweep)\n";
+        exit(1);
+    }
+
+    if (!sweep) {
+        options.block_duration = block_durations[0];
+        options.time_slice = time_slices[0];
+        options.cpus = cpus[0];
+        Scheduler s(argv[1], options); //create scheduler object and pass in command line arguments
+    } else if (strcmp(argv[1], "-") == 0) {
+        std::cerr << "Invalid argument - (standard input cannot be swept)\n";
+        exit(1);
+    } else {
+        Scheduler s(argv[1]); //parse the workload once and share it across the sweep
+        s.Sweep(block_durations, time_slices, cpus, options);
+    }
 
     return 0;
 }
-
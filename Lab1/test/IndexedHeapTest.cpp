@@ -0,0 +1,174 @@
+/*
+ * IndexedHeapTest - randomized check of IndexedHeap against std::set
+ *
+ * Runs random push, pop, update and remove operations on two heaps of one
+ * Group() and mirrors each on an ordered std::set of (key, order, index) per
+ * heap. Every 1000 operations both heaps are saved to a checkpoint file and
+ * loaded back. After every operation the smallest entry, size, keys and
+ * contains() of every index must agree with the sets; pops must come out in
+ * the sets' order.
+ * Prints "ok" or the first mismatch, exiting with status 1.
+ *
+ * Build and run from Lab1:
+ *  g++ -std=c++17 -O2 -I. test/IndexedHeapTest.cpp IndexedHeap.cpp Checkpoint.cpp MappedFile.cpp -o heaptest
+ *  ./heaptest [rounds [seed]]
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <random>
+#include <set>
+#include <tuple>
+#include <vector>
+
+#include <unistd.h>
+
+#include "IndexedHeap.h"
+
+using std::cout;
+using std::cerr;
+
+typedef std::tuple<long long, long long, int> Entry; //key, order, index
+
+static const int CAPACITY = 64; //indices, few enough that they are often reused
+static const int HEAPS = 2;
+static const int SAVE_EVERY = 1000; //operations between checkpoint round trips
+
+/**
+ * Checks one heap against its set
+ * @param heap
+ * @param expected
+ * @param step operation number, for the error message
+ */
+static void Check(const IndexedHeap& heap, const std::set<Entry>& expected, long long step) {
+    if (heap.size() != static_cast<int> (expected.size())) {
+        cerr << "ERROR: step " << step << ": size " << heap.size() << ", expected " << expected.size() << "\n";
+        exit(1);
+    }
+    if (!expected.empty() && heap.top() != std::get<2>(*expected.begin())) {
+        cerr << "ERROR: step " << step << ": top " << heap.top() << ", expected "
+                << std::get<2>(*expected.begin()) << "\n";
+        exit(1);
+    }
+    std::vector<bool> queued(CAPACITY, false);
+    for (const Entry& e : expected) {
+        queued[std::get<2>(e)] = true;
+        if (heap.key(std::get<2>(e)) != std::get<0>(e)) {
+            cerr << "ERROR: step " << step << ": key of " << std::get<2>(e) << " is " << heap.key(std::get<2>(e))
+                    << ", expected " << std::get<0>(e) << "\n";
+            exit(1);
+        }
+    }
+    for (int i = 0; i < CAPACITY; ++i) {
+        if (heap.contains(i) != queued[i]) {
+            cerr << "ERROR: step " << step << ": contains(" << i << ") is " << heap.contains(i) << "\n";
+            exit(1);
+        }
+    }
+}
+
+/**
+ * Finds the set entry of an index
+ * @param expected
+ * @param index
+ * @return
+ */
+static std::set<Entry>::iterator Find(std::set<Entry>& expected, int index) {
+    for (auto it = expected.begin(); it != expected.end(); ++it) {
+        if (std::get<2>(*it) == index) {
+            return it;
+        }
+    }
+    return expected.end();
+}
+
+int main(int argc, char** argv) {
+    long long rounds = (argc > 1) ? atoll(argv[1]) : 200000;
+    unsigned seed = (argc > 2) ? atoi(argv[2]) : 1;
+    std::mt19937 random(seed);
+    auto uniform = [&random](int n) {
+        return static_cast<int> (random() % n);
+    };
+
+    std::vector<IndexedHeap> heaps = IndexedHeap::Group(HEAPS, CAPACITY / 2);
+    for (IndexedHeap& heap : heaps) {
+        heap.resize(CAPACITY); //grows the shared arrays, as the Scheduler does when processes arrive
+    }
+    std::vector<std::set<Entry>> expected(HEAPS);
+    std::vector<int> owner(CAPACITY, -1); //heap holding each index, an index is in one heap at most
+    long long order = 0;
+    char path[] = "/tmp/lab1-heaptestXXXXXX";
+    int fd = mkstemp(path);
+    if (fd == -1) {
+        cerr << "ERROR: failure while creating file: " << path << "\n";
+        exit(2);
+    }
+    close(fd);
+
+    for (long long step = 0; step < rounds; ++step) {
+        int h = uniform(HEAPS);
+        IndexedHeap& heap = heaps[h];
+        std::set<Entry>& set = expected[h];
+        int index = uniform(CAPACITY);
+        long long key = uniform(16); //small keys, so ties are common
+        switch (uniform(5)) {
+            case 0:
+            case 1: //push
+                if (owner[index] == -1) {
+                    heap.push(index, key, order);
+                    set.insert(Entry(key, order, index));
+                    owner[index] = h;
+                    ++order;
+                }
+                break;
+            case 2: //pop
+                if (!set.empty()) {
+                    int popped = heap.pop();
+                    if (popped != std::get<2>(*set.begin())) {
+                        cerr << "ERROR: step " << step << ": popped " << popped << ", expected "
+                                << std::get<2>(*set.begin()) << "\n";
+                        exit(1);
+                    }
+                    set.erase(set.begin());
+                    owner[popped] = -1;
+                }
+                break;
+            case 3: //update
+                if (owner[index] == h) {
+                    auto it = Find(set, index);
+                    long long entryOrder = std::get<1>(*it);
+                    set.erase(it);
+                    set.insert(Entry(key, entryOrder, index));
+                    heap.update(index, key);
+                }
+                break;
+            case 4: //remove, also of indices in the other heap or in none, which must be left alone
+                heap.remove(index);
+                if (owner[index] == h) {
+                    set.erase(Find(set, index));
+                    owner[index] = -1;
+                }
+                break;
+        }
+        if (step % SAVE_EVERY == SAVE_EVERY - 1) { //save both heaps, then load them back
+            {
+                CheckpointWriter out(path);
+                for (const IndexedHeap& h : heaps) {
+                    h.save(out);
+                }
+                out.commit();
+            }
+            CheckpointReader in(path);
+            for (IndexedHeap& h : heaps) {
+                h.load(in);
+            }
+        }
+        for (int i = 0; i < HEAPS; ++i) {
+            Check(heaps[i], expected[i], step);
+        }
+    }
+    unlink(path);
+    cout << "ok" << std::endl;
+    return 0;
+}
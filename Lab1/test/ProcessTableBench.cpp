@@ -0,0 +1,123 @@
+/*
+ * ProcessTableBench - memory and scan speed of the process storage layouts
+ *
+ * Builds the same generated workload twice: as the Scheduler stored it
+ * before ProcessTable, one Process struct per process (AOS), and as a
+ * ProcessTable with the ProcessState of one run (SOA), both in their
+ * initial state. Then times a scan of two columns the simulation keeps,
+ * arrival_time + remaining_time summed over every process (repeated until
+ * at least 10M processes were visited), in each layout, and prints one line
+ * per layout:
+ *  LAYOUT PROCESSES BYTES_PER_PROCESS SCANNED SECONDS PROCESSES_PER_SEC
+ * BYTES_PER_PROCESS counts the columns, names included, from bytes().
+ *
+ * Build and run from Lab1:
+ *  g++ -std=c++17 -O2 -I. test/ProcessTableBench.cpp ProcessTable.cpp StringPool.cpp Checkpoint.cpp MappedFile.cpp -o tablebench
+ *  ./tablebench [processes]
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "ProcessTable.h"
+
+using std::cout;
+using std::cerr;
+
+static const long long SCAN_PROCESSES = 10000000; //processes visited by each scan, at least
+
+/**
+ * A process as Scheduler::Process stored it before ProcessTable
+ */
+struct Process {
+    std::string name; //name of process
+    int arrival_time; //arrival time of process in system
+    int total_time; //total time needed for process to run
+    int block_interval; //interval of time process blocks for I/O
+    int remaining_time;
+    long long termination_time;
+    long long time_blocked;
+    int time_until_blocked;
+    bool is_blocked;
+};
+
+/**
+ * Prints the line of one layout
+ * @param layout
+ * @param count
+ * @param bytes
+ * @param scanned
+ * @param seconds
+ */
+static void Print(const char* layout, int count, size_t bytes, long long scanned, double seconds) {
+    cout << layout << "\t" << count << "\t" << bytes / static_cast<double> (count) << "\t" << scanned << "\t"
+            << seconds << "\t" << scanned / seconds << std::endl;
+}
+
+int main(int argc, char** argv) {
+    int count = (argc > 1) ? atoi(argv[1]) : 1000000;
+    if (count <= 0) {
+        cerr << "usage: tablebench [processes]\n";
+        exit(1);
+    }
+    long long rounds = (SCAN_PROCESSES + count - 1) / count;
+
+    //workload: one arrival per time unit, bursts of 1 to 100
+    ProcessTable table;
+    unsigned random = 1;
+    for (int i = 0; i < count; ++i) {
+        random = random * 1103515245 + 12345;
+        table.add(table.names.intern("p" + std::to_string(i)), i, 1 + (random >> 16) % 100, (random >> 8) % 8);
+    }
+    ProcessState state(table);
+
+    std::vector<Process> processes(count);
+    size_t aosBytes = processes.capacity() * sizeof (Process);
+    for (int i = 0; i < count; ++i) {
+        Process& p = processes[i];
+        p.name = table.name(i);
+        p.arrival_time = table.arrival_time[i];
+        p.total_time = table.total_time[i];
+        p.block_interval = table.block_interval[i];
+        p.remaining_time = state.remaining_time[i];
+        p.termination_time = -1;
+        p.time_blocked = 0;
+        p.time_until_blocked = 0;
+        p.is_blocked = false;
+        if (p.name.capacity() > 15) { //longer than the string's own buffer
+            aosBytes += p.name.capacity() + 1;
+        }
+    }
+
+    cout << "LAYOUT\tPROCESSES\tBYTES_PER_PROCESS\tSCANNED\tSECONDS\tPROCESSES_PER_SEC" << std::endl;
+    auto start = std::chrono::steady_clock::now();
+    long long aosSum = 0;
+    for (long long r = 0; r < rounds; ++r) {
+        for (const Process& p : processes) {
+            aosSum += p.arrival_time + p.remaining_time;
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    Print("AOS", count, aosBytes, rounds * count, seconds);
+
+    start = std::chrono::steady_clock::now();
+    long long soaSum = 0;
+    const int* arrival = table.arrival_time.data();
+    const int* remaining = state.remaining_time.data();
+    for (long long r = 0; r < rounds; ++r) {
+        for (int i = 0; i < count; ++i) {
+            soaSum += arrival[i] + remaining[i];
+        }
+    }
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    Print("SOA", count, table.bytes() + state.bytes(), rounds * count, seconds);
+
+    if (aosSum != soaSum) {
+        cerr << "ERROR: the layouts disagree: " << aosSum << " " << soaSum << "\n";
+        exit(2);
+    }
+    return 0;
+}
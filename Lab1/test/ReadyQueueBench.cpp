@@ -0,0 +1,101 @@
+/*
+ * ReadyQueueBench - cost of a context switch with each ready list
+ *
+ * Runs a round robin with time slice 1 over processes which all arrive at 0
+ * and never block, once with the ready list RoundRobin used before
+ * ReadyQueue, a linear scan of every process for the oldest ready stamp
+ * (SCAN), and once with ReadyQueue's ring buffer (RING). Only the ready list
+ * is exercised; there is no output or event handling. Prints one line per
+ * ready list:
+ *  QUEUE PROCESSES SWITCHES SECONDS NS_PER_SWITCH
+ *
+ * Build and run from Lab1:
+ *  g++ -std=c++17 -O2 -I. test/ReadyQueueBench.cpp ReadyQueue.cpp Checkpoint.cpp MappedFile.cpp -o queuebench
+ *  ./queuebench [processes [burst]]
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "ReadyQueue.h"
+
+using std::cout;
+using std::cerr;
+
+/**
+ * The ready list RoundRobin used before ReadyQueue: a ready flag and an
+ * insertion stamp per process, with the next process found by scanning
+ * every process for the oldest stamp
+ */
+class ScanQueue {
+public:
+    ScanQueue(int capacity) : ready(capacity, 0), order(capacity), stamp(0), count(0) {}
+
+    void push(int index) {
+        ready[index] = 1;
+        order[index] = stamp++;
+        ++count;
+    }
+
+    int pop() {
+        int readyIndex = -1;
+        for (int i = 0; i < static_cast<int> (ready.size()); ++i) {
+            if (ready[i] && (readyIndex == -1 || order[i] < order[readyIndex])) {
+                readyIndex = i;
+            }
+        }
+        ready[readyIndex] = 0;
+        --count;
+        return readyIndex;
+    }
+
+    bool empty() const { return count == 0; }
+
+private:
+    std::vector<char> ready; //process is in the ready list
+    std::vector<long long> order; //insertion stamp, lowest runs next
+    long long stamp; //number of insertions so far
+    int count; //processes in the ready list
+};
+
+/**
+ * Times the switches of one ready list and prints its line
+ * @param name
+ * @param count number of processes
+ * @param burst CPU time of every process, in slices of 1
+ */
+template <class Queue>
+void SwitchCost(const char* name, int count, int burst) {
+    auto start = std::chrono::steady_clock::now();
+    Queue ready(count);
+    std::vector<int> remaining(count, burst);
+    for (int i = 0; i < count; ++i) {
+        ready.push(i);
+    }
+    long long switches = 0;
+    while (!ready.empty()) {
+        int current = ready.pop();
+        ++switches;
+        if (--remaining[current] > 0) {
+            ready.push(current);
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    cout << name << "\t" << count << "\t" << switches << "\t" << seconds << "\t" << seconds * 1e9 / switches
+            << std::endl;
+}
+
+int main(int argc, char** argv) {
+    int count = (argc > 1) ? atoi(argv[1]) : 5000;
+    int burst = (argc > 2) ? atoi(argv[2]) : 20;
+    if (count <= 0 || burst <= 0) {
+        cerr << "usage: queuebench [processes [burst]]\n";
+        exit(1);
+    }
+    cout << "QUEUE\tPROCESSES\tSWITCHES\tSECONDS\tNS_PER_SWITCH" << std::endl;
+    SwitchCost<ScanQueue>("SCAN", count, burst);
+    SwitchCost<ReadyQueue>("RING", count, burst);
+    return 0;
+}